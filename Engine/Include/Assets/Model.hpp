@@ -4,6 +4,7 @@
 #include "RigelAsset.hpp"
 #include "Handles/AssetHandle.hpp"
 #include "Assets/Material.hpp"
+#include "Bounds.hpp"
 
 #include <filesystem>
 #include <memory>
@@ -77,6 +78,9 @@ namespace Rigel
         ~Model() override;
 
         NODISCARD NodeIterator GetNodeIterator() const { return NodeIterator(m_RootNode); }
+
+        // Bounds of all meshes of the model in model space, node transforms included
+        NODISCARD const AABB& GetBounds() const { return m_Bounds; }
     INTERNAL:
         NODISCARD Ref<Backend::Vulkan::VK_VertexBuffer> GetVertexBuffer() const { return m_VertexBuffer.get(); }
         NODISCARD Ref<Backend::Vulkan::VK_IndexBuffer> GetIndexBuffer() const { return m_IndexBuffer.get(); }
@@ -90,6 +94,8 @@ namespace Rigel
         std::shared_ptr<Backend::ModelNode> m_RootNode;
         std::vector<AssetHandle<Material>> m_Materials;
 
+        AABB m_Bounds;
+
         friend class AssetManager;
     };
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core.hpp"
+#include "RigelAsset.hpp"
+#include "Handles/GOHandle.hpp"
+
+#include "nlohmann_json/json_fwd.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <filesystem>
+
+namespace Rigel
+{
+    /**
+     * Asset that stores a game object and its descendants as a template, which can be instantiated
+     * any number of times with Scene::Instantiate.
+     *
+     * Prefab files contain the game objects in the same json format scenes use, the root object comes first.
+     * Use Prefab::Serialize to create the json of a prefab from objects that already exist.
+     */
+    class Prefab final : public RigelAsset
+    {
+    public:
+        ~Prefab() override;
+
+        /**
+         * Serializes the object and all of its descendants into prefab json, which can be saved to a prefab file.
+         * @return Prefab json or an empty json object if the handle is invalid
+         */
+        NODISCARD static nlohmann::json Serialize(const GOHandle& root);
+
+        // Number of game objects created by a single instance of the prefab
+        NODISCARD size_t GetObjectCount() const { return m_ObjectCount; }
+    INTERNAL:
+        NODISCARD const nlohmann::json& GetGameObjects() const { return *m_GameObjects; }
+
+        /**
+         * IDs of the serialized game objects and components, each object followed by its components.
+         * An instance takes one ID per entry, entry i of the instance gets the instance's first ID + i.
+         */
+        NODISCARD const std::vector<uid_t>& GetSerializedIDs() const { return m_SerializedIDs; }
+
+        // Number of components of each type in a single instance, keyed by the registered type name
+        NODISCARD const std::unordered_map<std::string, size_t>& GetComponentCounts() const { return m_ComponentCounts; }
+    private:
+        Prefab(const std::filesystem::path& path, const uid_t id) noexcept;
+        ErrorCode Init() override;
+
+        std::unique_ptr<nlohmann::json> m_GameObjects;
+        std::vector<uid_t> m_SerializedIDs;
+        std::unordered_map<std::string, size_t> m_ComponentCounts;
+        size_t m_ObjectCount = 0;
+
+        friend class AssetManager;
+    };
+}
@@ -4,6 +4,7 @@
 #include "RigelObject.hpp"
 #include "Handles/HandleValidator.hpp"
 
+#include <atomic>
 #include <filesystem>
 #include <condition_variable>
 #include <mutex>
@@ -19,7 +20,7 @@ namespace Rigel
         ~RigelAsset() noexcept override
         {
             using namespace Backend::HandleValidation;
-            HandleValidator::RemoveHandle<HandleType::AssetHandle>(this->GetID());
+            HandleValidator::RemoveHandle<HandleType::AssetHandle>(*this);
         }
 
         NODISCARD bool IsOK() const { return IsLoadFinished() && IsInitialized(); }
@@ -47,7 +48,7 @@ namespace Rigel
             : RigelObject(id), m_Path(std::move(path))
         {
             using namespace Backend::HandleValidation;
-            HandleValidator::AddHandle<HandleType::AssetHandle>(this->GetID());
+            HandleValidator::AddHandle<HandleType::AssetHandle>(*this);
         }
 
         virtual ErrorCode Init() = 0;
@@ -58,6 +59,7 @@ namespace Rigel
         const std::filesystem::path m_Path;
     INTERNAL:
         bool m_IsPersistent = false;
+        std::atomic<uint32_t> m_RefCount = 0; // Number of AssetHandles pointing to this asset
     private:
         friend class AssetManager;
 
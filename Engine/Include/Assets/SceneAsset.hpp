@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Core.hpp"
+#include "RigelAsset.hpp"
+
+#include <memory>
+#include <filesystem>
+
+namespace Rigel
+{
+    class Scene;
+
+    /**
+     * Asset that deserializes a scene file into a new scene, which is used to stream scenes in the background.
+     * Both json and binary scenes (see Scene::SerializeBinary) are supported, the format is detected from the file contents.
+     *
+     * When loaded with AssetManager::LoadAsync the whole scene, including its game objects and components,
+     * is created on a loading thread. The scene is not known to the SceneManager until it is taken
+     * out of the asset and adopted, so component Deserialize methods must not touch any global state.
+     */
+    class SceneAsset final : public RigelAsset
+    {
+    public:
+        ~SceneAsset() override;
+    INTERNAL:
+        // Hands the scene over to the caller. Returns nullptr if loading failed or the scene was already taken
+        NODISCARD std::unique_ptr<Scene> TakeScene();
+    private:
+        SceneAsset(const std::filesystem::path& path, const uid_t id) noexcept;
+        ErrorCode Init() override;
+
+        std::unique_ptr<Scene> m_Scene;
+
+        friend class AssetManager;
+    };
+}
@@ -3,6 +3,7 @@
 #include "Core.hpp"
 #include "Math.hpp"
 #include "ECS/Component.hpp"
+#include "ECS/TagLayerIndex.hpp"
 
 namespace Rigel
 {
@@ -19,6 +20,10 @@ namespace Rigel
 
         void SetFov(const float32_t fov);
         void SetPlanes(const float32_t nearPlane, const float32_t farPlane);
+
+        // Only objects on layers included in the mask are rendered by this camera
+        void SetCullingMask(const LayerMask mask) { m_CullingMask = mask; }
+        NODISCARD LayerMask GetCullingMask() const { return m_CullingMask; }
     private:
         Camera();
         Camera(const float32_t fov, const float32_t nearPlane, const float32_t farPlane);
@@ -33,6 +38,7 @@ namespace Rigel
         float32_t m_FOV;
         float32_t m_Near;
         float32_t m_Far;
+        LayerMask m_CullingMask = ALL_LAYERS;
 
         glm::mat4 m_Projection{};
         glm::mat4 m_View{};
@@ -24,6 +24,7 @@ namespace Rigel
         explicit ModelRenderer(const std::filesystem::path& modelPath);
 
         void OnLoad() override;
+        void OnDestroy() override;
 
         AssetHandle<Model> m_Model;
         std::optional<std::filesystem::path> m_ModelPath;
@@ -4,6 +4,8 @@
 #include "Math.hpp"
 #include "ECS/Component.hpp"
 #include "Handles/ComponentHandle.hpp"
+#include "ECS/TransformHierarchy.hpp"
+#include "ECS/SpatialIndex.hpp"
 
 #include <vector>
 
@@ -18,28 +20,36 @@ namespace Rigel
         static constexpr auto WORLD_RIGHT = glm::vec3(1.0, 0.0, 0.0);
         static constexpr auto WORLD_FORWARD = glm::vec3(0.0, 0.0, -1.0);
 
-        NODISCARD glm::vec3 GetPosition();
-        NODISCARD glm::quat GetRotation();
-        NODISCARD glm::vec3 GetScale();
+        NODISCARD glm::vec3 GetPosition() const;
+        NODISCARD glm::quat GetRotation() const;
+        NODISCARD glm::vec3 GetScale() const;
 
-        NODISCARD glm::vec3 GetLocalPosition();
-        NODISCARD glm::quat GetLocalRotation();
-        NODISCARD glm::vec3 GetLocalScale();
+        NODISCARD glm::vec3 GetLocalPosition() const;
+        NODISCARD glm::quat GetLocalRotation() const;
+        NODISCARD glm::vec3 GetLocalScale() const;
 
-        NODISCARD glm::vec3 GetForwardVector();
-        NODISCARD glm::vec3 GetRightVector();
-        NODISCARD glm::vec3 GetUpVector();
+        NODISCARD glm::vec3 GetForwardVector() const;
+        NODISCARD glm::vec3 GetRightVector() const;
+        NODISCARD glm::vec3 GetUpVector() const;
 
         void SetLocalPosition(const glm::vec3& position);
         void SetLocalRotation(const glm::quat& rotation);
         void SetLocalRotation(const glm::vec3& rotation);
         void SetLocalScale(const glm::vec3& scale);
 
-        NODISCARD glm::mat4 GetLocalMatrix();
-        NODISCARD glm::mat4 GetWorldMatrix();
+        NODISCARD glm::mat4 GetLocalMatrix() const;
+        NODISCARD glm::mat4 GetWorldMatrix() const;
+
+        /**
+         * Returns a version that changes every time the world matrix of this transform gets recomputed,
+         * either because the transform itself or one of its ancestors was modified.
+         * Versions only ever increase, cache data derived from the world matrix alongside this value.
+         */
+        NODISCARD uint64_t GetChangeVersion() const;
 
         NODISCARD ComponentHandle<Transform> GetParent() const { return m_Parent; }
 
+        // Parent and child must be on the same scene
         void SetParent(ComponentHandle<Transform>& parent);
         void AddChild(ComponentHandle<Transform>& child);
         void RemoveChild(ComponentHandle<Transform>& child);
@@ -48,35 +58,45 @@ namespace Rigel
 
         NODISCARD nlohmann::json Serialize() const override;
         bool Deserialize(const nlohmann::json& json) override;
+
+        NODISCARD bool SerializeBinary(BinaryWriter& writer) const override;
+        bool DeserializeBinary(BinaryReader& reader) override;
     private:
         Transform();
         Transform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+        ~Transform() override;
+
+        void OnResolveReferences(const IDRemapTable& table) override;
 
-        void OnLoad() override;
-        void UpdateOnDemand();
+        // Called by GameObject when the transform is registered, moves the transform data into the scene's hierarchy
+        void AttachToHierarchy(Backend::TransformHierarchy& hierarchy);
+
+        // Called by Scene before the owner is destroyed, removes the transform from its parent and makes its children roots
+        void DetachFromParentAndChildren();
+
+        NODISCARD Backend::TransformHierarchy& GetHierarchy() const
+        {
+            ASSERT(m_Hierarchy, "Transform is not attached to a scene hierarchy");
+            return *m_Hierarchy;
+        }
 
-        void UpdateImpl();
         NODISCARD static glm::vec3 ExtractWorldScale(const glm::mat4& matrix);
 
         ComponentHandle<Transform> m_Parent{};
         std::vector<ComponentHandle<Transform>> m_Children{};
+        std::vector<uid_t> m_SerializedChildren{}; // Only used between Deserialize and OnResolveReferences
 
-        glm::vec3 m_LocalPosition;
-        glm::quat m_LocalRotation;
-        glm::vec3 m_LocalScale;
-
-        glm::vec3 m_WorldPosition;
-        glm::quat m_WorldRotation;
-        glm::vec3 m_WorldScale;
+        // Only used until the transform is attached to the hierarchy, which owns the data afterward
+        glm::vec3 m_InitialPosition;
+        glm::quat m_InitialRotation;
+        glm::vec3 m_InitialScale;
 
-        glm::mat4 m_LocalMatrix{1.0};
-        glm::mat4 m_WorldMatrix{1.0};
-        glm::mat4 m_NormalMatrix{1.0};
+        Backend::TransformHierarchy* m_Hierarchy = nullptr;
+        uint32_t m_HierarchyIndex = 0; // Changes whenever the hierarchy gets re-sorted
 
-        glm::vec3 m_ForwardVector{};
-        glm::vec3 m_RightVector{};
-        glm::vec3 m_UpVector{};
+        uint32_t m_SpatialProxy = SpatialIndex::NULL_PROXY; // Leaf of the scene's spatial index, maintained by Scene
 
-        bool m_UpdateRequiredFlag = true;
+        friend class Backend::TransformHierarchy;
+        friend class Scene;
     };
 }
@@ -29,6 +29,8 @@ namespace Rigel
         FAILED_TO_OPEN_FILE = 101,
         NLOHMANN_JSON_PARSING_ERROR = 102,
         NLOHMANN_JSON_READING_ERROR = 103,
+        FAILED_TO_MAP_FILE = 104,
+        BINARY_DATA_READING_ERROR = 105,
 
         // Assets
         FAILED_TO_LOAD_ASSET = 201,
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ECS/ComponentStorage.hpp"
+
+#include <vector>
+
+namespace Rigel::Backend
+{
+    /**
+     * Keeps the update loops of component types that opted into batched updates with RIGEL_BATCHED_UPDATE.
+     *
+     * A batched update calls the update method of every component of one type from a single loop over
+     * the type's storage. The call is resolved at compile time and components are visited in memory order,
+     * instead of going through a separate EventManager callback per component.
+     */
+    class BatchedUpdateRegistry
+    {
+    public:
+        using UpdateLoopFunc = void(*)(const ComponentStorageRegistry&);
+
+        // T must provide a static _batched_update_(T&) function, which RIGEL_BATCHED_UPDATE defines
+        template<typename T>
+        struct Registrar
+        {
+            Registrar()
+            {
+                GetUpdateLoops().push_back(&UpdateLoop);
+            }
+
+            static void UpdateLoop(const ComponentStorageRegistry& storages)
+            {
+                if (const auto storage = storages.FindStorage<T>())
+                    storage->ForEachUpdatable([](T& component) { T::_batched_update_(component); });
+            }
+        };
+
+        // Runs the update loops of all registered component types over the given storages
+        static void Update(const ComponentStorageRegistry& storages)
+        {
+            for (const auto loop : GetUpdateLoops())
+                loop(storages);
+        }
+    private:
+        static std::vector<UpdateLoopFunc>& GetUpdateLoops()
+        {
+            static auto loops = std::vector<UpdateLoopFunc>();
+            return loops;
+        }
+    };
+}
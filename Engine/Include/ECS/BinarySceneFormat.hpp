@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ECS/TagLayerIndex.hpp"
+#include "Utilities/Serialization/BinaryStream.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Rigel
+{
+    class Scene;
+    class Component;
+}
+
+namespace Rigel::Backend
+{
+    /**
+     * Binary counterpart of the scene json, meant to be memory mapped and loaded with as few copies as possible.
+     * Json remains the interchange and debugging format, both describe the same data.
+     *
+     * Layout, all values in native byte order:
+     *  - Header
+     *  - Scene name
+     *  - ObjectRecord for every game object, followed by a single string with all object names
+     *  - One block per component type: BlockHeader, type name, ComponentRecord for every component
+     *    of the type and the payload of all of them
+     *
+     * Records are plain data, each table is copied out of the file with a single memcpy.
+     * Payloads are written by Component::SerializeBinary, components of types that don't implement it
+     * are stored as MessagePack of their json. Blocks of unknown component types are skipped.
+     */
+    class BinarySceneFormat
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+
+        NODISCARD static std::vector<byte_t> Write(const Scene& scene);
+        static bool Read(Scene& scene, std::span<const byte_t> data);
+
+        // True if the data starts with the binary scene signature, used to tell binary scenes from json
+        NODISCARD static bool IsBinaryScene(std::span<const byte_t> data);
+    private:
+        static constexpr char MAGIC[4] = {'R', 'G', 'S', 'C'};
+
+        enum class Encoding : uint32_t
+        {
+            Binary = 0,
+            MessagePack = 1
+        };
+
+        struct Header
+        {
+            char Magic[4];
+            uint32_t Version;
+            uint64_t NextObjectID;
+            uint32_t ObjectCount;
+            uint32_t BlockCount;
+        };
+
+        // IDs are always stored as 64 bit values, so that files don't depend on RIGEL_USE_64_BIT_ID_TYPE
+        struct ObjectRecord
+        {
+            uint64_t ID;
+            TagMask Tags;
+            uint32_t Layer;
+            uint32_t NameSize;
+            uint64_t NameOffset; // Into the names string that follows the records
+            uint8_t Active;
+            uint8_t Padding[7];
+        };
+
+        struct BlockHeader
+        {
+            Encoding PayloadEncoding;
+            uint32_t ComponentCount;
+            uint64_t PayloadSize;
+        };
+
+        struct ComponentRecord
+        {
+            uint64_t ID;
+            uint64_t PayloadOffset; // Into the payload of the block
+            uint32_t PayloadSize;
+            uint32_t ObjectIndex; // Index of the owner's ObjectRecord
+            uint8_t Active;
+            uint8_t Padding[7];
+        };
+
+        static_assert(sizeof(Header) == 24 && sizeof(ObjectRecord) == 40 && sizeof(ComponentRecord) == 32,
+            "Binary scene records must not contain implicit padding");
+
+        static void WriteBlock(BinaryWriter& writer, std::span<const std::pair<uint32_t, const Component*>> components);
+        static bool ReadComponentPayload(Component& component, const Encoding encoding, std::span<const byte_t> payload);
+    };
+}
@@ -3,6 +3,8 @@
 #include "Core.hpp"
 #include "RigelObject.hpp"
 #include "Engine.hpp"
+#include "ECS/ComponentStorage.hpp"
+#include "ECS/BatchedUpdate.hpp"
 #include "Handles/GOHandle.hpp"
 #include "Handles/SceneHandle.hpp"
 #include "Subsystems/EventSystem/Event.hpp"
@@ -11,19 +13,46 @@
 #include "Utilities/Reflection/ITypeRegistrable.hpp"
 #include "Utilities/Reflection/TypeRegistry.hpp"
 
+#include <algorithm>
 #include <type_traits>
-#include <typeindex>
-#include <unordered_map>
+#include <vector>
 
 /**
  * @brief A Component specific version of RIGEL_REGISTER_TYPE macro, see it's description for more info.
  */
 #define RIGEL_REGISTER_COMPONENT(Type) \
     friend class Rigel::GameObject; \
+    friend class Rigel::Backend::ComponentStorage<Type>; \
+    friend class Rigel::ObjectPool<Type>; \
+    inline static Rigel::Backend::ComponentStorageRegistry::Registrar<Type> _component_storage_registrar_ = \
+    Rigel::Backend::ComponentStorageRegistry::Registrar<Type>(#Type); \
     RIGEL_REGISTER_TYPE(Type)
 
+/**
+ * @brief Opts a component type into batched updates.
+ *
+ * Method is called once per frame for every active component of the type by a single loop over the
+ * component storage of the loaded scene, the way SubscribeEvent<GameUpdateEvent> would call it, but without
+ * a separate event callback per component. Use it instead of subscribing Method to GameUpdateEvent.
+ * Method must take no arguments, it may be private.
+ */
+#define RIGEL_BATCHED_UPDATE(Type, Method) \
+    friend struct Rigel::Backend::BatchedUpdateRegistry::Registrar<Type>; \
+    static void _batched_update_(Type& component) { component.Method(); } \
+    inline static Rigel::Backend::BatchedUpdateRegistry::Registrar<Type> _batched_update_registrar_ = \
+    Rigel::Backend::BatchedUpdateRegistry::Registrar<Type>()
+
 namespace Rigel
 {
+    class IDRemapTable;
+    class BinaryWriter;
+    class BinaryReader;
+
+    namespace Backend
+    {
+        class BinarySceneFormat;
+    }
+
     class Component : public RigelObject, public ISerializable, public ITypeRegistrable
     {
     public:
@@ -35,8 +64,18 @@ namespace Rigel
         NODISCARD SceneHandle GetScene() const { return m_Scene; }
         NODISCARD GOHandle GetGameObject() const { return m_GameObject; }
 
+        /**
+         * Enables or disables the component itself. The component only runs while it is also
+         * active in the hierarchy, i.e. its game object and all of the object's parents are active.
+         */
         void SetActive(const bool active);
         NODISCARD bool IsActive() const { return m_Active; }
+
+        // True if the component and its game object are active, which requires every parent object to be active as well
+        NODISCARD bool IsActiveInHierarchy() const { return m_ActiveInHierarchy; }
+    INTERNAL:
+        // Dense ID of the derived component type, assigned by the storage the component was created in
+        NODISCARD type_id_t GetComponentTypeID() const { return m_TypeID; }
     protected:
         Component();
 
@@ -47,15 +86,32 @@ namespace Rigel
         virtual void OnEnable() { }
         virtual void OnDisable() { }
 
+        /**
+         * Called after the whole scene was deserialized, before any OnLoad invocation.
+         * Override to turn IDs of other objects stored in serialized data back into handles.
+         * @param table Maps serialized IDs to the objects created from them
+         */
+        virtual void OnResolveReferences(const IDRemapTable& table) { }
+
         NODISCARD nlohmann::json Serialize() const override;
         bool Deserialize(const nlohmann::json& json) override;
 
+        /**
+         * Binary counterparts of Serialize and Deserialize used by binary scenes, see Backend::BinarySceneFormat.
+         * ID and active state are stored by the scene, only data of the derived type has to be written.
+         *
+         * Components that don't override them are stored as MessagePack of their json. An override must
+         * support every component of its type, SerializeBinary returns false without writing anything otherwise.
+         */
+        NODISCARD virtual bool SerializeBinary(BinaryWriter& writer) const { return false; }
+        virtual bool DeserializeBinary(BinaryReader& reader) { return false; }
+
         /**
          * @brief Subscribes a component method to an event of the specified type.
          *
          * Use this method to subscribe components to engine events (e.g. GameUpdateEvent or PhysicsTickEvent)
          * Using this method insures that all callbacks will be automatically unsubscribed when this component is destroyed
-         * and suspended when it becomes inactive.
+         * and skipped while it is not active in the hierarchy.
          *
          * Note that only one callback per event type is allowed at a time. Swapping callback methods
          * after they have already been subscribed is also not allowed.
@@ -69,23 +125,27 @@ namespace Rigel
         {
             static_assert(std::is_base_of_v<Component, T>, "Callback owning class must inherit from Rigel::Component!");
 
-            const auto typeIndex = TYPE_INDEX(EventType);
-            if (m_EventsRegistry.contains(typeIndex))
+            const auto eventTypeID = EventTypeID::Get<EventType>();
+            if (std::ranges::find(m_EventsRegistry, eventTypeID, &EventRegistryEntry::EventID) != m_EventsRegistry.end())
             {
                 Debug::Error("Component with ID {} has already subscribed to an event of type {}!",
                     this->GetID(), TypeUtility::GetTypeName<EventType>());
                 return;
             }
 
-            const auto callbackID = GetEventManager()->Subscribe(typeIndex, static_cast<T*>(this), callback);
+            const auto callbackID = GetEventManager()->Subscribe(eventTypeID, static_cast<T*>(this), callback);
 
-            m_EventsRegistry[typeIndex] = callbackID;
+            m_EventsRegistry.emplace_back(eventTypeID, callbackID);
         }
     private:
         SceneHandle m_Scene;
         GOHandle m_GameObject;
         bool m_Active = true;
-        bool m_Loaded = false;
+        bool m_ActiveInHierarchy = true; // Cached m_Active && owner's active in hierarchy state
+        bool m_Loaded = false; // Set once both OnLoad and OnStart ran
+
+        uint32_t m_StorageSlot = 0; // Index of the slot this component occupies inside its ComponentStorage
+        type_id_t m_TypeID = 0; // ComponentTypeID of the derived type
 
         // Use these methods to propagate events instead of calling virtual event methods directly
         void CallOnLoad();
@@ -94,8 +154,21 @@ namespace Rigel
         void CallOnEnable();
         void CallOnDisable();
 
-        std::unordered_map<std::type_index, uid_t> m_EventsRegistry{};
+        // Recomputes the cached active in hierarchy state, mirrors it in the storage and calls OnEnable/OnDisable
+        void UpdateActiveInHierarchy(const bool ownerActive);
+
+        struct EventRegistryEntry
+        {
+            type_id_t EventID;
+            uid_t CallbackID;
+        };
+
+        // Components subscribe to a handful of events at most, a linear search beats hashing here
+        std::vector<EventRegistryEntry> m_EventsRegistry{};
 
         friend class GameObject;
+        template<typename> friend class Backend::ComponentStorage;
+        friend class IDRemapTable;
+        friend class Backend::BinarySceneFormat;
     };
 }
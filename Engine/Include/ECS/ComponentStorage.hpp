@@ -0,0 +1,200 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Debug.hpp"
+#include "Utilities/ObjectPool.hpp"
+#include "Utilities/Reflection/TypeID.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Rigel
+{
+    class Component;
+
+    // Dense IDs of component types, used to index per-type component data
+    using ComponentTypeID = TypeID<Component>;
+}
+
+namespace Rigel::Backend
+{
+    /**
+     * Type erased interface of a per-type component storage.
+     * Allows the scene to create and destroy components whose type is only known at runtime.
+     */
+    class IComponentStorage
+    {
+    public:
+        virtual ~IComponentStorage() = default;
+
+        // Default-constructs a component inside the storage, used when the concrete type is not known statically
+        NODISCARD virtual Component* CreateDefault() = 0;
+        virtual void Destroy(Component* component) = 0;
+
+        // Active components are the ones enabled and attached to an object that is active in the hierarchy
+        virtual void SetActive(const Component* component, const bool active) = 0;
+
+        // Makes room for count more components, see ObjectPool::Reserve
+        virtual void Reserve(const size_t count) = 0;
+
+        NODISCARD virtual size_t GetSize() const = 0;
+    };
+
+    /**
+     * Keeps all components of type T in a pool of fixed-size chunks of contiguous memory.
+     *
+     * Components never move once created, so raw pointers stored inside handles stay valid
+     * until the component is destroyed. Destroyed slots are recycled by subsequent creations.
+     * Active state of every component is mirrored in the pool's active bits, so iterating active components
+     * skips inactive ones without touching them.
+     */
+    template<typename T>
+    class ComponentStorage final : public IComponentStorage
+    {
+    public:
+        using Iterator = typename ObjectPool<T>::Iterator;
+
+        ComponentStorage() = default;
+        ~ComponentStorage() override = default;
+
+        ComponentStorage(const ComponentStorage&) = delete;
+        ComponentStorage& operator = (const ComponentStorage&) = delete;
+
+        template<typename... Args>
+        NODISCARD T* Create(Args&&... args)
+        {
+            uint32_t slot;
+            const auto component = m_Pool.Emplace(slot, std::forward<Args>(args)...);
+
+            component->m_StorageSlot = slot;
+            component->m_TypeID = ComponentTypeID::Get<T>();
+
+            return component;
+        }
+
+        NODISCARD Component* CreateDefault() override
+        {
+            return Create();
+        }
+
+        void Destroy(Component* component) override
+        {
+            ASSERT(m_Pool.Get(component->m_StorageSlot) == static_cast<T*>(component), "Component does not belong to this storage");
+            m_Pool.Erase(component->m_StorageSlot);
+        }
+
+        void SetActive(const Component* component, const bool active) override
+        {
+            m_Pool.SetActive(component->m_StorageSlot, active);
+        }
+
+        void Reserve(const size_t count) override { m_Pool.Reserve(count); }
+
+        NODISCARD size_t GetSize() const override { return m_Pool.GetSize(); }
+
+        NODISCARD Iterator begin() const { return m_Pool.begin(); }
+        NODISCARD Iterator end() const { return m_Pool.end(); }
+
+        // Iterates components that are active in the hierarchy only, use end() as the end of the range
+        NODISCARD Iterator ActiveBegin() const { return m_Pool.ActiveBegin(); }
+
+        /**
+         * Calls func for every component that would receive its event callbacks,
+         * i.e. components that are active in the hierarchy and have finished loading.
+         */
+        template<typename Func>
+        void ForEachUpdatable(Func&& func) const
+        {
+            for (auto it = m_Pool.ActiveBegin(); it != m_Pool.end(); ++it)
+            {
+                if (it->m_Loaded)
+                    func(*it);
+            }
+        }
+    private:
+        ObjectPool<T> m_Pool;
+    };
+
+    /**
+     * Owns one ComponentStorage per component type attached to objects of a scene.
+     */
+    class ComponentStorageRegistry
+    {
+    public:
+        using StorageFactoryFunc = std::unique_ptr<IComponentStorage>(*)();
+
+        /**
+         * Registers the storage factory of a component type under its name,
+         * this allows deserialization to construct components directly inside their storage.
+         * Also makes sure every registered component type gets its ComponentTypeID during static initialization.
+         */
+        template<typename T>
+        struct Registrar
+        {
+            explicit Registrar(const std::string& name)
+            {
+                GetFactories()[name] = {ComponentTypeID::Get<T>(), []() -> std::unique_ptr<IComponentStorage>
+                {
+                    return std::make_unique<ComponentStorage<T>>();
+                }};
+            }
+        };
+
+        ComponentStorageRegistry() = default;
+        ~ComponentStorageRegistry() = default;
+
+        ComponentStorageRegistry(const ComponentStorageRegistry&) = delete;
+        ComponentStorageRegistry& operator = (const ComponentStorageRegistry&) = delete;
+
+        // Returns the storage for components of type T, creating it if it doesn't exist yet
+        template<typename T>
+        NODISCARD ComponentStorage<T>& GetStorage()
+        {
+            auto& storage = GetStorageSlot(ComponentTypeID::Get<T>());
+            if (!storage)
+                storage = std::make_unique<ComponentStorage<T>>();
+
+            return static_cast<ComponentStorage<T>&>(*storage);
+        }
+
+        // Returns the storage for components of type T or nullptr if no component of that type was ever created
+        template<typename T>
+        NODISCARD ComponentStorage<T>* FindStorage() const
+        {
+            if (const auto typeID = ComponentTypeID::Get<T>(); typeID < m_Storages.size())
+                return static_cast<ComponentStorage<T>*>(m_Storages[typeID].get());
+
+            return nullptr;
+        }
+
+        // Returns the storage for components of the type registered under the given name or nullptr if the name is unknown
+        NODISCARD IComponentStorage* GetStorage(const std::string& typeName);
+
+        // Returns the storage that owns the given component
+        NODISCARD IComponentStorage& GetStorage(const Component& component);
+    private:
+        struct FactoryEntry
+        {
+            type_id_t ID = 0;
+            StorageFactoryFunc Factory = nullptr;
+        };
+
+        NODISCARD std::unique_ptr<IComponentStorage>& GetStorageSlot(const type_id_t typeID)
+        {
+            if (typeID >= m_Storages.size())
+                m_Storages.resize(typeID + 1);
+
+            return m_Storages[typeID];
+        }
+
+        static std::unordered_map<std::string, FactoryEntry>& GetFactories()
+        {
+            static auto factories = std::unordered_map<std::string, FactoryEntry>();
+            return factories;
+        }
+
+        std::vector<std::unique_ptr<IComponentStorage>> m_Storages; // Indexed by ComponentTypeID
+    };
+}
@@ -3,17 +3,19 @@
 #include "Core.hpp"
 #include "Debug.hpp"
 #include "Handles/ComponentHandle.hpp"
-#include "Handles/HandleValidator.hpp"
 #include "Component.hpp"
 #include "Utilities/Serialization/ISerializable.hpp"
 #include "RigelObject.hpp"
 #include "Handles/SceneHandle.hpp"
+#include "ECS/ComponentStorage.hpp"
+#include "ECS/IDRemapTable.hpp"
+#include "ECS/TagLayerIndex.hpp"
 #include "Components/Transform.hpp"
 
+#include <ranges>
 #include <string>
-#include <typeindex>
 #include <type_traits>
-#include <unordered_map>
+#include <vector>
 
 namespace Rigel
 {
@@ -31,9 +33,33 @@ namespace Rigel
 
         NODISCARD std::string GetName() const { return m_Name; }void SetName(std::string name) { m_Name = std::move(name); }
 
+        /**
+         * Activates or deactivates the object. Deactivating an object also deactivates all of its children
+         * in the transform hierarchy, the children keep their own active state and get it back once the object is activated.
+         */
         void SetActive(const bool active);
         NODISCARD bool IsActive() const { return m_Active; }
 
+        // True if the object and all of its parents are active
+        NODISCARD bool IsActiveInHierarchy() const { return m_ActiveInHierarchy; }
+
+        /**
+         * Tags are IDs of ProjectSettings::TagsMap entries, an object can have any number of them.
+         * Use Scene::FindGameObjectsWithTag to get all objects with a tag without searching.
+         */
+        void AddTag(const uid_t tag);
+        void RemoveTag(const uid_t tag);
+        NODISCARD bool HasTag(const uid_t tag) const { return tag < MAX_TAGS && (m_Tags & (1ull << tag)); }
+        NODISCARD TagMask GetTags() const { return m_Tags; }
+
+        /**
+         * Layers are IDs of ProjectSettings::LayersMap entries, every object is on exactly one layer.
+         * Use Scene::FindGameObjectsInLayer to get all objects on a layer without searching.
+         */
+        void SetLayer(const uid_t layer);
+        NODISCARD uint32_t GetLayer() const { return m_Layer; }
+        NODISCARD LayerMask GetLayerMask() const { return 1u << m_Layer; }
+
         // Returns handle to the scene this object is attached to
         NODISCARD SceneHandle GetScene() const { return m_Scene; }
 
@@ -72,23 +98,19 @@ namespace Rigel
                 return ComponentHandle<T>::Null();
             }
 
-            const auto component = static_cast<Component*>(new T(std::forward<Args>(args)...));
+            const auto component = static_cast<Component*>(m_ComponentStorages->GetStorage<T>().Create(std::forward<Args>(args)...));
             component->m_Scene = m_Scene;
             component->m_GameObject = GOHandle(this, this->GetID());
 
             // ID assigning implemented as a private method to allow RigelObject::OverrideID to remain internal
             const auto id = AssignIDToComponent(component);
+            RegisterComponent(component);
 
-            using namespace Backend::HandleValidation;
-            HandleValidator::AddHandle<HandleType::ComponentHandle>(id);
-
-            m_Components[TYPE_INDEX(T)] = std::unique_ptr<Component>(component);
-
+            // If the object hasn't started yet, its OnStart will start the new component as well
             if (m_Loaded)
-            {
                 component->CallOnLoad();
+            if (m_Started)
                 component->CallOnStart();
-            }
 
             return ComponentHandle<T>(static_cast<T*>(component), id);
         }
@@ -114,15 +136,13 @@ namespace Rigel
                 return;
             }
 
-            const auto index = TYPE_INDEX(T);
+            const auto component = m_Components[ComponentTypeID::Get<T>()];
 
             if (m_Loaded)
-                m_Components[index]->CallOnDestroy();
-
-            using namespace Backend::HandleValidation;
-            HandleValidator::RemoveHandle<HandleType::ComponentHandle>(m_Components.at(index)->GetID());
+                component->CallOnDestroy();
 
-            m_Components.erase(index);
+            UnregisterComponent(component);
+            m_ComponentStorages->GetStorage<T>().Destroy(component);
         }
 
         /**
@@ -133,9 +153,8 @@ namespace Rigel
         template<ComponentConcept T>
         NODISCARD ComponentHandle<T> GetComponent() const
         {
-            if (const auto index = TYPE_INDEX(T); m_Components.contains(index))
-                return ComponentHandle<T>(static_cast<T*>(m_Components.at(index).get()),
-                    m_Components.at(index)->GetID());
+            if (const auto component = TryGetComponent<T>())
+                return ComponentHandle<T>(component, component->GetID());
 
             Debug::Error("Component of type {} is not attached to game object with ID {}!", TypeUtility::GetTypeName<T>(), GetID());
             return ComponentHandle<T>::Null();
@@ -149,39 +168,100 @@ namespace Rigel
         template<ComponentConcept T>
         NODISCARD bool HasComponent() const
         {
-            return m_Components.contains(TYPE_INDEX(T));
+            return TryGetComponent<T>() != nullptr;
         }
     INTERNAL:
         ~GameObject() override;
 
+        // Returns a raw pointer to the component of type T or nullptr if it is not attached, never reports errors
+        template<ComponentConcept T>
+        NODISCARD T* TryGetComponent() const
+        {
+            const auto typeID = ComponentTypeID::Get<T>();
+            return typeID < m_Components.size() ? static_cast<T*>(m_Components[typeID]) : nullptr;
+        }
+
         NODISCARD std::vector<ComponentHandle<Component>> GetComponents() const
         {
             auto vec = std::vector<GenericComponentHandle>();
-            vec.reserve(m_Components.size());
+            vec.reserve(m_ComponentCount);
 
-            for (const auto& component : m_Components | std::views::values)
-                vec.emplace_back(component.get(), component->GetID());
+            for (const auto component : m_Components)
+            {
+                if (component)
+                    vec.emplace_back(component, component->GetID());
+            }
 
             return vec;
         }
+
+        /**
+         * Recomputes the active in hierarchy state from the parent object and propagates it to the components
+         * and, if it changed, to the whole subtree. Called whenever the object gets a new parent.
+         */
+        void UpdateActiveInHierarchy();
     private:
         explicit GameObject(const uid_t id, std::string name);
 
         void OnLoad(); // Handles asset loading.
         void OnStart(); // Handles start behaviour that does not involve loading assets, guaranteed to run after OnLoad.
         void OnDestroy(); // Handles freeing assets and other behaviour that may be required during object's destruction.
+        void ResolveReferences(const IDRemapTable& table); // Called by Scene::Deserialize once all objects exist
+
+        /**
+         * Deserializes the object as a new copy of the serialized one, used to instantiate prefabs.
+         * The object gets firstID and its components the following IDs in the order they are serialized,
+         * IDs of components that fail to deserialize are skipped. Components get no handle slots,
+         * the caller must assign them before any handle to the components is created.
+         */
+        bool DeserializeCopy(const nlohmann::json& json, const uid_t firstID) { return DeserializeImpl(json, firstID); }
+
+        // Keeps the serialized IDs if firstID is NULL_ID
+        bool DeserializeImpl(const nlohmann::json& json, const uid_t firstID);
 
         NODISCARD uid_t AssignIDToComponent(Component* ptr);
 
+        // Makes the component visible to the object, the scene ID index and handle validation
+        void RegisterComponent(Component* component, const bool assignHandle = true);
+        void UnregisterComponent(Component* component);
+
+        // Skips the empty slots of m_Components
+        NODISCARD auto GetAttachedComponents() const
+        {
+            return m_Components | std::views::filter([](const Component* component) { return component != nullptr; });
+        }
+
+        uint32_t m_PoolSlot = 0; // Index of the slot this object occupies inside the scene's object pool
+
         // m_Loaded defines whether loading logic for Components should be executed,
         // will be set to true in OnLoad method, which is called by Scene::OnLoad
         bool m_Loaded = false;
+        bool m_Started = false; // Lags behind m_Loaded by a few frames when the scene is loaded incrementally
         bool m_Active = true;
+        bool m_ActiveInHierarchy = true; // Cached m_Active && parent's active in hierarchy state
+
+        TagMask m_Tags = 0;
+        uint32_t m_Layer = 0;
+
+        // Positions of the object inside the scene's tag and layer lists, maintained by TagLayerIndex.
+        // m_TagSlots holds one entry per set bit of m_Tags, ordered by tag ID
+        std::vector<uint32_t> m_TagSlots;
+        uint32_t m_LayerSlot = 0;
 
         SceneHandle m_Scene;
         std::string m_Name;
-        std::unordered_map<std::type_index, std::unique_ptr<Component>> m_Components;
+
+        // Components are owned by the scene's per-type storages, the object only keeps track of its own ones
+        Ref<Backend::ComponentStorageRegistry> m_ComponentStorages;
+        // Indexed by ComponentTypeID, nullptr for types that are not attached
+        std::vector<Component*> m_Components;
+        size_t m_ComponentCount = 0;
 
         friend class Scene;
+        friend class Component;
+        friend class Backend::TagLayerIndex;
+        friend class Backend::BinarySceneFormat;
+        friend class ObjectPool<GameObject>;
+        template<typename, typename...> friend class SceneQuery;
     };
 }
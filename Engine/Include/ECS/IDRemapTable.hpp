@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ECS/Component.hpp"
+#include "Handles/GOHandle.hpp"
+#include "Handles/ComponentHandle.hpp"
+
+#include <unordered_map>
+
+namespace Rigel
+{
+    class GameObject;
+
+    /**
+     * Maps object IDs stored in serialized data to the live objects that were created from that data.
+     *
+     * Built in a single pass while a scene is deserialized and handed to every component
+     * through Component::OnResolveReferences, so components that store handles to other objects
+     * can turn serialized IDs back into handles without searching the scene.
+     */
+    class IDRemapTable
+    {
+    public:
+        IDRemapTable() = default;
+        ~IDRemapTable() = default;
+
+        IDRemapTable(const IDRemapTable&) = delete;
+        IDRemapTable& operator = (const IDRemapTable&) = delete;
+
+        void Reserve(const size_t count) { m_Entries.reserve(count); }
+
+        // Removes all entries but keeps the memory, so one table can be reused for many copies of the same objects
+        void Clear() { m_Entries.clear(); }
+
+        void AddGameObject(const uid_t serializedID, GameObject* gameObject);
+        void AddComponent(const uid_t serializedID, Component* component);
+
+        // Returns a handle to the game object created from the given serialized ID or a null handle if there is none
+        NODISCARD GOHandle ResolveGameObject(const uid_t serializedID) const;
+
+        // Returns a handle to the component created from the given serialized ID or a null handle if there is none
+        NODISCARD GenericComponentHandle ResolveComponent(const uid_t serializedID) const;
+
+        /**
+         * Typed version of ResolveComponent.
+         * @return A handle to the component or a null handle if there is no such component or it is not of type T
+         */
+        template<typename T>
+        NODISCARD ComponentHandle<T> ResolveComponent(const uid_t serializedID) const
+        {
+            const auto entry = FindEntry(serializedID);
+            if (!entry || !entry->ComponentPtr || entry->ComponentPtr->GetComponentTypeID() != ComponentTypeID::Get<T>())
+                return ComponentHandle<T>::Null();
+
+            return {static_cast<T*>(entry->ComponentPtr), entry->ID};
+        }
+
+        NODISCARD size_t GetSize() const { return m_Entries.size(); }
+    private:
+        struct Entry
+        {
+            GameObject* ObjectPtr = nullptr;
+            Component* ComponentPtr = nullptr; // nullptr for game object entries
+            uid_t ID = NULL_ID; // The ID of the live object, may differ from the serialized one
+        };
+
+        NODISCARD const Entry* FindEntry(const uid_t serializedID) const
+        {
+            const auto it = m_Entries.find(serializedID);
+            return it != m_Entries.end() ? &it->second : nullptr;
+        }
+
+        std::unordered_map<uid_t, Entry> m_Entries;
+    };
+}
@@ -2,15 +2,28 @@
 
 #include "Core.hpp"
 #include "GameObject.hpp"
+#include "ComponentStorage.hpp"
+#include "SceneQuery.hpp"
+#include "SceneCommandBuffer.hpp"
+#include "TransformHierarchy.hpp"
+#include "TagLayerIndex.hpp"
+#include "BinarySceneFormat.hpp"
+#include "SpatialIndex.hpp"
 #include "RigelObject.hpp"
+#include "Utilities/ObjectPool.hpp"
 #include "Handles/GOHandle.hpp"
+#include "Handles/AssetHandle.hpp"
+#include "Assets/Prefab.hpp"
 #include "Utilities/Serialization/ISerializable.hpp"
 
 #include "plf/plf_colony.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <queue>
+#include <span>
+#include <vector>
 
 namespace Rigel
 {
@@ -23,14 +36,42 @@ namespace Rigel
         NODISCARD nlohmann::json Serialize() const override;
         bool Deserialize(const nlohmann::json& json) override;
 
+        /**
+         * Serializes the scene into the binary scene format, which is much smaller and faster to load than json.
+         * Json stays the format for interchange and debugging, see Backend::BinarySceneFormat for details.
+         */
+        NODISCARD std::vector<byte_t> SerializeBinary() const { return Backend::BinarySceneFormat::Write(*this); }
+
+        // Binary counterpart of Deserialize, the data is usually a MappedFile of a scene saved with SerializeBinary
+        bool DeserializeBinary(std::span<const byte_t> data) { return Backend::BinarySceneFormat::Read(*this, data); }
+
         NODISCARD std::string GetName() const { return m_Name; }
         void SetName(std::string name) { m_Name = std::move(name); }
 
-        NODISCARD size_t GetSize() const { return m_GameObjects.size(); }
+        NODISCARD size_t GetSize() const { return m_GameObjects.GetSize(); }
 
         NODISCARD bool IsLoaded() const { return m_Loaded; }
 
+        // True while the scene is being loaded incrementally, see SceneManager::LoadSceneIncremental
+        NODISCARD bool IsLoading() const { return m_LoadPhase != LoadPhase::None; }
+
+        /**
+         * Returns how much of an incremental load is done, from 0 to 1. OnLoad of all objects makes up
+         * the first half and OnStart the second. Returns 1 if the scene isn't being loaded incrementally.
+         */
+        NODISCARD float32_t GetLoadProgress() const;
+
         GOHandle Instantiate(std::string name = "GameObject");
+
+        /**
+         * Creates count copies of the prefab at once. Much faster than instantiating the objects one by one,
+         * IDs, storage and handle slots are reserved for all copies up front and, if the scene is loaded,
+         * OnLoad runs for all new objects before OnStart runs for any of them.
+         * @param prefab A loaded prefab asset
+         * @param count Number of copies to create
+         * @return Handles to the root objects of the copies
+         */
+        std::vector<GOHandle> Instantiate(const AssetHandle<Prefab>& prefab, const size_t count = 1);
         void Destroy(const GOHandle& handle);
 
         /**
@@ -41,6 +82,16 @@ namespace Rigel
          */
         void DestroyImmediately(const GOHandle& handle) { DestroyGOImpl(handle.GetID()); }
 
+        /**
+         * Creates a buffer that records structural changes to be applied to this scene at the end of the frame.
+         * This is the only way to modify the scene from worker threads, see SceneCommandBuffer for details.
+         *
+         * Safe to call from any thread. The buffer is owned by the scene and stays valid until it is played back.
+         * @param sortKey Buffers are played back in ascending sort key order, buffers with equal keys
+         * in the order they were created. Use it to keep playback deterministic when buffers are created by parallel jobs.
+         */
+        NODISCARD Ref<SceneCommandBuffer> CreateCommandBuffer(const uint64_t sortKey = 0);
+
         /**
          * Searches objects on the scene by given conditional function
          * @param condition Custom function that determines what objects are selected
@@ -51,10 +102,43 @@ namespace Rigel
 
         NODISCARD GOHandle FindGameObjectByID(const uid_t id) const;
 
+        /**
+         * Returns all game objects that have the given tag, including inactive ones, in no particular order.
+         * The span is invalidated by any change of tags and by instantiating or destroying objects.
+         */
+        NODISCARD std::span<const GOHandle> FindGameObjectsWithTag(const uid_t tag) const;
+
+        /**
+         * Returns all game objects on the given layer, including inactive ones, in no particular order.
+         * The span is invalidated by any change of layers and by instantiating or destroying objects.
+         */
+        NODISCARD std::span<const GOHandle> FindGameObjectsInLayer(const uid_t layer) const;
+
+        /**
+         * Returns the bounding volume hierarchy over all objects of the scene, use it for overlap, frustum,
+         * ray and nearest object queries instead of iterating objects. Only maintained while the scene is loaded.
+         */
+        NODISCARD const SpatialIndex& GetSpatialIndex() const { return m_SpatialIndex; }
+
+        /**
+         * Returns a lazy view over all active game objects that have every one of the listed components attached.
+         * Nothing is allocated and only objects that have the first listed component are visited,
+         * so list the rarest component first. See SceneQuery for details.
+         * @tparam First The component type whose storage drives the iteration
+         * @tparam Rest Other component types that must be present on the same game object
+         */
+        template<ComponentConcept First, ComponentConcept... Rest>
+        NODISCARD SceneQuery<First, Rest...> Query() const
+        {
+            return SceneQuery<First, Rest...>(m_ComponentStorages.FindStorage<First>());
+        }
+
         /**
          * Finds and returns all components of the specified type in the scene.
          * This method searches through all active GameObjects and retrieves components
          * that match the provided type.
+         *
+         * Copies the results into a new vector, prefer Query when the components only need to be iterated.
          * @tparam T The type of the components to find.
          * @return A list of components of the specified type found in the scene.
          */
@@ -63,60 +147,132 @@ namespace Rigel
         {
             auto components = std::vector<ComponentHandle<T>>();
 
-            for (const auto& go : m_GameObjects)
+            for (const auto& [component] : Query<T>())
             {
-                if (go->HasComponent<T>())
-                {
-                    if (const auto cmp = go->GetComponent<T>(); cmp->IsActive())
-                        components.push_back(cmp);
-                }
-
-                if (components.size() > maxComponents)
-                    return components;
+                if (components.size() >= maxComponents)
+                    break;
+
+                components.push_back(component);
             }
 
             return components;
         }
 
-        NODISCARD GenericComponentHandle FindComponentByID(const uid_t id) const
-        {
-            for (const auto& go : m_GameObjects)
-            {
-                for (const auto& component : go->GetComponents())
-                {
-                    if (component.GetID() == id)
-                        return component;
-                }
-            }
+        NODISCARD GenericComponentHandle FindComponentByID(const uid_t id) const;
 
-            return GenericComponentHandle::Null();
+        /**
+         * Returns transforms whose world matrix changed during this frame's transform update, parents before children.
+         * The list is rebuilt once per frame, it can be used to process only the transforms that actually moved.
+         */
+        NODISCARD const std::vector<ComponentHandle<Transform>>& GetChangedTransforms() const
+        {
+            return m_TransformHierarchy.GetChangedTransforms();
         }
     INTERNAL:
         ~Scene() override;
 
         // use to assign unique IDs to game objects and components
         NODISCARD uid_t GetNextObjectID() { return m_NextObjectID++; }
+
+        NODISCARD Backend::TransformHierarchy& GetTransformHierarchy() { return m_TransformHierarchy; }
+        NODISCARD Backend::TagLayerIndex& GetTagLayerIndex() { return m_TagLayerIndex; }
+
+        // Makes the spatial index recompute bounds of the object during the next transform update,
+        // used when bounds change without the transform changing (e.g. a model finished loading)
+        void InvalidateBounds(const ComponentHandle<Transform>& transform) { m_PendingBounds.push_back(transform); }
+
+        // Keep the ID index up to date, called by GameObject when components are attached or removed
+        void IndexComponent(GameObject* owner, Component* component);
+        void UnindexObject(const uid_t id);
+
+        // Destroys every object on the scene, must be called before the scene's handle is removed
+        void DestroyAllGameObjects();
     private:
+        /**
+         * Entry of the ID index. Game objects and components share the same ID space, so a single map is used for both.
+         * IDs only ever grow and serialized scenes may contain any of them, so the map is keyed by ID rather than
+         * being a table indexed by it, its size follows the number of live objects.
+         */
+        struct IndexEntry
+        {
+            GameObject* ObjectPtr = nullptr; // The indexed object itself or the owner of the indexed component
+            Component* ComponentPtr = nullptr; // nullptr for game object entries
+        };
+
+        NODISCARD const IndexEntry* FindIndexEntry(const uid_t id) const
+        {
+            const auto it = m_ObjectIndex.find(id);
+            return it != m_ObjectIndex.end() ? &it->second : nullptr;
+        }
+
+        void IndexGameObject(GameObject* go);
+
         explicit Scene(const uid_t id, std::string name = "New scene");
 
-        void OnLoad(); // Called by SceneManager::Load
+        // Called by SceneManager::Load, an incremental load only snapshots the objects, ContinueLoad activates them
+        void OnLoad(const bool incremental = false);
         void OnUnload(); // Called by SceneManager
 
-        void OnEndOfFrame(); // Used to process GO deletion queue
+        /**
+         * Runs OnLoad and then OnStart of the objects snapshot by an incremental OnLoad until the budget is used up.
+         * At least one object is processed per call. OnStart of the first object only runs once OnLoad ran for all of them.
+         * @param budget Time limit in milliseconds, checked after every object
+         * @return True once all objects were started and the scene is fully loaded
+         */
+        bool ContinueLoad(const float64_t budget);
 
-        void DestroyGOImpl(const uid_t id); // the actual GO destroy logic
+        // Runs OnLoad and OnStart of new objects, or queues them if the scene is still being loaded incrementally
+        void ActivateGameObjects(std::span<GameObject* const> objects);
+
+        void OnEndOfFrame(); // Used to play back command buffers and process GO deletion queue
+        void OnTransformUpdate(); // Propagates world matrices of all transforms and refits the spatial index
+        void UpdateSpatialIndex();
+        bool UpdateBounds(ComponentHandle<Transform> transform); // Returns false if the bounds are not final yet
+        void PlaybackCommandBuffers();
+
+        void DestroyGOImpl(const uid_t id, const bool detachTransform = true); // the actual GO destroy logic
 
         // Defines whether loading logic for GOs/Components should be executed,
         // will be set to true in OnLoad method when this scene gets loaded via SceneManager::Load
         bool m_Loaded = false;
 
+        enum class LoadPhase : uint8_t
+        {
+            None,
+            Loading, // OnLoad runs for the objects in m_PendingActivation
+            Starting // OnStart runs for the objects in m_PendingActivation
+        };
+
+        LoadPhase m_LoadPhase = LoadPhase::None;
+        std::vector<GOHandle> m_PendingActivation; // Objects of an incremental load, in activation order
+        size_t m_ActivationCursor = 0; // Next object of m_PendingActivation to be processed in the current phase
+
         std::string m_Name;
         uid_t m_NextObjectID = 1;
         uid_t m_EndOfFrameCallbackID = NULL_ID;
+        uid_t m_GameUpdateCallbackID = NULL_ID;
+        uid_t m_TransformUpdateCallbackID = NULL_ID;
+
+        // Must outlive the components, transforms remove themselves from the hierarchy on destruction
+        Backend::TransformHierarchy m_TransformHierarchy;
+
+        Backend::TagLayerIndex m_TagLayerIndex;
 
-        plf::colony<std::unique_ptr<GameObject>> m_GameObjects;
+        SpatialIndex m_SpatialIndex;
+        std::vector<ComponentHandle<Transform>> m_PendingBounds;
+
+        // Must be declared before m_GameObjects, objects return their components to the storages
+        // and remove them from the ID index on destruction
+        Backend::ComponentStorageRegistry m_ComponentStorages;
+
+        std::unordered_map<uid_t, IndexEntry> m_ObjectIndex;
+        ObjectPool<GameObject> m_GameObjects;
         std::queue<GOHandle> m_DestroyQueue;
 
+        std::vector<std::unique_ptr<SceneCommandBuffer>> m_CommandBuffers;
+        std::mutex m_CommandBuffersMutex;
+
         friend class SceneManager;
+        friend class Backend::BinarySceneFormat;
     };
 }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Core.hpp"
+#include "GameObject.hpp"
+#include "Handles/GOHandle.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Rigel
+{
+    class Scene;
+
+    /**
+     * Records structural changes of a scene so that they can be applied later on the main thread.
+     *
+     * Scene is not thread-safe, game objects can't be created, destroyed or modified while other threads access it.
+     * Instead, every worker thread records its changes into its own buffer obtained from Scene::CreateCommandBuffer
+     * and the scene plays all buffers back at the end of the frame, before processing its destroy queue.
+     *
+     * A single buffer must only be recorded from one thread at a time. Buffers are played back ordered by their
+     * sort key and then by creation order, commands inside a buffer are played back in the order they were recorded.
+     */
+    class SceneCommandBuffer
+    {
+    public:
+        /**
+         * Refers to a game object that will be created by this buffer during playback.
+         * Can be used with other commands recorded into the same buffer.
+         */
+        struct DeferredGameObject
+        {
+            uint32_t Index = 0;
+        };
+
+        NODISCARD DeferredGameObject Instantiate(std::string name = "GameObject");
+
+        void Destroy(const GOHandle& target);
+        void Destroy(const DeferredGameObject target);
+
+        void SetActive(const GOHandle& target, const bool active);
+        void SetActive(const DeferredGameObject target, const bool active);
+
+        /**
+         * Records adding a component of type T to the target game object.
+         * The arguments are copied into the buffer and forwarded to the component's constructor during playback.
+         */
+        template<ComponentConcept T, typename... Args>
+        void AddComponent(const GOHandle& target, Args&&... args)
+        {
+            Record(Target(target), MakeAddCommand<T>(std::forward<Args>(args)...));
+        }
+
+        template<ComponentConcept T, typename... Args>
+        void AddComponent(const DeferredGameObject target, Args&&... args)
+        {
+            Record(Target(target), MakeAddCommand<T>(std::forward<Args>(args)...));
+        }
+
+        template<ComponentConcept T>
+        void RemoveComponent(const GOHandle& target)
+        {
+            Record(Target(target), [](GOHandle& go) { go->RemoveComponent<T>(); });
+        }
+
+        template<ComponentConcept T>
+        void RemoveComponent(const DeferredGameObject target)
+        {
+            Record(Target(target), [](GOHandle& go) { go->RemoveComponent<T>(); });
+        }
+
+        NODISCARD size_t GetSize() const { return m_Commands.size(); }
+        NODISCARD bool IsEmpty() const { return m_Commands.empty(); }
+    INTERNAL:
+        explicit SceneCommandBuffer(const uint64_t sortKey) : m_SortKey(sortKey) { }
+
+        NODISCARD uint64_t GetSortKey() const { return m_SortKey; }
+
+        /**
+         * Applies all recorded commands to the scene, must be called on the main thread.
+         * Commands recorded into this buffer during playback (e.g. by OnStart of an added component)
+         * are played back after all commands recorded before it.
+         */
+        void Playback(Scene& scene);
+    private:
+        enum class CommandType : uint8_t
+        {
+            Instantiate,
+            Destroy,
+            Modify // SetActive, AddComponent and RemoveComponent
+        };
+
+        // Either an existing game object or one instantiated by this buffer
+        struct Target
+        {
+            explicit Target(const GOHandle& handle) : Handle(handle) { }
+            explicit Target(const DeferredGameObject deferred) : DeferredIndex(deferred.Index), IsDeferred(true) { }
+
+            GOHandle Handle;
+            uint32_t DeferredIndex = 0;
+            bool IsDeferred = false;
+        };
+
+        struct Command
+        {
+            CommandType Type;
+            Target CommandTarget;
+            std::string Name; // Only used by Instantiate
+            std::move_only_function<void(GOHandle&)> Apply; // Only used by Modify
+        };
+
+        template<ComponentConcept T, typename... Args>
+        NODISCARD static std::move_only_function<void(GOHandle&)> MakeAddCommand(Args&&... args)
+        {
+            return [...capturedArgs = std::forward<Args>(args)](GOHandle& go) mutable
+            {
+                go->AddComponent<T>(std::move(capturedArgs)...);
+            };
+        }
+
+        void Record(const Target& target, std::move_only_function<void(GOHandle&)> apply)
+        {
+            m_Commands.push_back({.Type = CommandType::Modify, .CommandTarget = target, .Name = {}, .Apply = std::move(apply)});
+        }
+
+        static void PlaybackBatch(Scene& scene, std::vector<Command>& commands, const uint32_t instantiateCount);
+        NODISCARD static GOHandle Resolve(const Target& target, const std::vector<GOHandle>& instantiated);
+
+        uint64_t m_SortKey;
+        uint32_t m_InstantiateCount = 0;
+        std::vector<Command> m_Commands;
+    };
+}
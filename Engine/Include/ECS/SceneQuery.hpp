@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ECS/GameObject.hpp"
+#include "ECS/ComponentStorage.hpp"
+#include "Handles/ComponentHandle.hpp"
+
+#include <tuple>
+
+namespace Rigel
+{
+    /**
+     * A lazy view over all active game objects of a scene that have every one of the listed components attached.
+     * Only components that are active in the hierarchy are matched.
+     *
+     * The view walks the active components of the first listed type and checks the remaining ones on the owner of
+     * each component, so nothing is allocated and only objects that have the first component active are touched.
+     * List the rarest component first to get the fastest iteration.
+     *
+     * Dereferencing the iterator yields a tuple of handles, one per listed type:
+     * @code
+     * for (auto [renderer, transform] : scene->Query<ModelRenderer, Transform>()) { ... }
+     * @endcode
+     */
+    template<typename First, typename... Rest>
+    class SceneQuery
+    {
+    public:
+        using ValueType = std::tuple<ComponentHandle<First>, ComponentHandle<Rest>...>;
+        using StorageIterator = typename Backend::ComponentStorage<First>::Iterator;
+
+        class Iterator
+        {
+        public:
+            Iterator(const StorageIterator it, const StorageIterator end)
+                : m_Iterator(it), m_End(end)
+            {
+                SkipMismatches();
+            }
+
+            ValueType operator * () const
+            {
+                auto& component = *m_Iterator;
+                const auto& owner = component.GetGameObject();
+
+                return ValueType(ComponentHandle<First>(&component, component.GetID()),
+                    MakeHandle(owner->template TryGetComponent<Rest>())...);
+            }
+
+            Iterator& operator ++ ()
+            {
+                ++m_Iterator;
+                SkipMismatches();
+                return *this;
+            }
+
+            bool operator == (const Iterator& other) const { return m_Iterator == other.m_Iterator; }
+        private:
+            template<typename T>
+            NODISCARD static ComponentHandle<T> MakeHandle(T* component)
+            {
+                return {component, component->GetID()};
+            }
+
+            NODISCARD static bool IsActiveComponent(const Component* component)
+            {
+                return component && component->IsActiveInHierarchy();
+            }
+
+            // The first component is known to be active, the storage iterator only visits active components
+            NODISCARD static bool Matches(const First& component)
+            {
+                if constexpr (sizeof...(Rest) == 0)
+                    return true;
+                else
+                {
+                    const auto& owner = component.GetGameObject();
+                    return (IsActiveComponent(owner->template TryGetComponent<Rest>()) && ...);
+                }
+            }
+
+            void SkipMismatches()
+            {
+                while (!(m_Iterator == m_End) && !Matches(*m_Iterator))
+                    ++m_Iterator;
+            }
+
+            StorageIterator m_Iterator;
+            StorageIterator m_End;
+        };
+
+        explicit SceneQuery(const Backend::ComponentStorage<First>* storage) : m_Storage(storage) { }
+
+        NODISCARD Iterator begin() const
+        {
+            if (!m_Storage)
+                return {StorageIterator(nullptr, 0, 0), StorageIterator(nullptr, 0, 0)};
+
+            return {m_Storage->ActiveBegin(), m_Storage->end()};
+        }
+
+        NODISCARD Iterator end() const
+        {
+            const auto endIt = m_Storage ? m_Storage->end() : StorageIterator(nullptr, 0, 0);
+            return {endIt, endIt};
+        }
+
+        NODISCARD bool IsEmpty() const { return begin() == end(); }
+
+        // Returns the first matching entry, only valid if the query is not empty
+        NODISCARD ValueType Front() const { return *begin(); }
+    private:
+        const Backend::ComponentStorage<First>* m_Storage;
+    };
+}
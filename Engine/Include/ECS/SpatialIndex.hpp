@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Math.hpp"
+#include "Bounds.hpp"
+#include "Handles/GOHandle.hpp"
+
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace Rigel
+{
+    /**
+     * Dynamic bounding volume hierarchy over the game objects of a scene.
+     *
+     * Every game object is a leaf, bounded by its ModelRenderer's model or, if it has none, by its position.
+     * Leaves store enlarged ("fat") bounds, objects that move within them don't change the tree at all.
+     * Objects that leave their fat bounds are removed and reinserted, the tree is kept balanced with rotations.
+     * Bounds are refitted once per frame after transforms are updated, only for transforms that actually changed.
+     *
+     * Queries report every object whose fat bounds pass the test, they are conservative and include inactive objects.
+     * The index must not be modified from query callbacks.
+     */
+    class SpatialIndex
+    {
+    public:
+        static constexpr uint32_t NULL_PROXY = std::numeric_limits<uint32_t>::max();
+
+        SpatialIndex() = default;
+        ~SpatialIndex() = default;
+
+        SpatialIndex(const SpatialIndex&) = delete;
+        SpatialIndex& operator = (const SpatialIndex&) = delete;
+
+        /**
+         * Calls func(const GOHandle&) for every object whose bounds overlap the box.
+         */
+        template<typename Func>
+        void QueryOverlap(const AABB& box, Func&& func) const
+        {
+            Traverse([&box](const AABB& bounds) { return bounds.Overlaps(box); }, [&func](const Node& leaf) { func(leaf.Object); });
+        }
+
+        /**
+         * Calls func(const GOHandle&) for every object whose bounds intersect the frustum.
+         */
+        template<typename Func>
+        void QueryFrustum(const Frustum& frustum, Func&& func) const
+        {
+            Traverse([&frustum](const AABB& bounds) { return frustum.Intersects(bounds); }, [&func](const Node& leaf) { func(leaf.Object); });
+        }
+
+        /**
+         * Calls func(const GOHandle&, float32_t distance) for every object whose bounds are hit by the ray,
+         * in no particular order. The distance is measured to the bounds, not to the object's geometry.
+         */
+        template<typename Func>
+        void Raycast(const Ray& ray, const float32_t maxDistance, Func&& func) const
+        {
+            const auto inverseDirection = 1.0f / ray.Direction;
+
+            Traverse([&](const AABB& bounds)
+            {
+                float32_t distance;
+                return ray.Intersects(bounds, inverseDirection, maxDistance, distance);
+            },
+            [&](const Node& leaf)
+            {
+                float32_t distance;
+                ray.Intersects(leaf.Bounds, inverseDirection, maxDistance, distance);
+                func(leaf.Object, distance);
+            });
+        }
+
+        /**
+         * Returns up to count objects closest to the point, nearest first.
+         * Distances are measured to the bounds of the objects.
+         */
+        NODISCARD std::vector<GOHandle> FindNearest(const glm::vec3& point, const size_t count,
+            const float32_t maxDistance = std::numeric_limits<float32_t>::max()) const;
+
+        NODISCARD size_t GetSize() const { return m_ProxyCount; }
+        NODISCARD uint32_t GetHeight() const { return m_Root == NULL_PROXY ? 0 : m_Nodes[m_Root].Height; }
+    INTERNAL:
+        NODISCARD uint32_t CreateProxy(const GOHandle& object, const AABB& bounds);
+        void DestroyProxy(const uint32_t proxy);
+
+        // Returns true if the proxy had to be reinserted, false if the new bounds still fit its fat bounds
+        bool MoveProxy(const uint32_t proxy, const AABB& bounds);
+
+        NODISCARD const AABB& GetFatBounds(const uint32_t proxy) const { return m_Nodes[proxy].Bounds; }
+    private:
+        struct Node
+        {
+            AABB Bounds;
+            GOHandle Object; // Only set for leaves
+
+            uint32_t Parent = NULL_PROXY; // Next free node while the node is unused
+            uint32_t Child1 = NULL_PROXY;
+            uint32_t Child2 = NULL_PROXY;
+            int32_t Height = 0; // 0 for leaves, -1 for unused nodes
+
+            NODISCARD bool IsLeaf() const { return Child1 == NULL_PROXY; }
+        };
+
+        // Depth first traversal without recursion, overlaps(bounds) prunes subtrees, visit(leaf) is called for leaves
+        template<typename Overlaps, typename Visit>
+        void Traverse(const Overlaps& overlaps, const Visit& visit) const
+        {
+            if (m_Root == NULL_PROXY)
+                return;
+
+            // The tree is balanced, so the fixed buffer only overflows for trees with billions of nodes
+            auto stack = std::array<uint32_t, 128>();
+            auto overflow = std::vector<uint32_t>();
+            size_t size = 0;
+
+            const auto push = [&](const uint32_t index)
+            {
+                if (size < stack.size())
+                    stack[size++] = index;
+                else
+                    overflow.push_back(index);
+            };
+
+            push(m_Root);
+            while (size > 0 || !overflow.empty())
+            {
+                uint32_t index;
+                if (!overflow.empty())
+                {
+                    index = overflow.back();
+                    overflow.pop_back();
+                }
+                else
+                    index = stack[--size];
+
+                const auto& node = m_Nodes[index];
+                if (!overlaps(node.Bounds))
+                    continue;
+
+                if (node.IsLeaf())
+                    visit(node);
+                else
+                {
+                    push(node.Child1);
+                    push(node.Child2);
+                }
+            }
+        }
+
+        NODISCARD uint32_t AllocateNode();
+        void FreeNode(const uint32_t index);
+
+        void InsertLeaf(const uint32_t leaf);
+        void RemoveLeaf(const uint32_t leaf);
+
+        // Performs a left or right rotation if the subtree rooted at index is imbalanced, returns the new subtree root
+        NODISCARD uint32_t Balance(const uint32_t index);
+
+        std::vector<Node> m_Nodes;
+        uint32_t m_Root = NULL_PROXY;
+        uint32_t m_FreeList = NULL_PROXY;
+        size_t m_ProxyCount = 0;
+    };
+}
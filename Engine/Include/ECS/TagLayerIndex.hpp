@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Handles/GOHandle.hpp"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace Rigel
+{
+    class GameObject;
+
+    // One bit per tag, tag IDs are the keys of ProjectSettings::TagsMap
+    using TagMask = uint64_t;
+
+    // One bit per layer, layer IDs are the keys of ProjectSettings::LayersMap
+    using LayerMask = uint32_t;
+
+    static constexpr uint32_t MAX_TAGS = 64;
+    static constexpr uint32_t MAX_LAYERS = 32;
+    static constexpr LayerMask ALL_LAYERS = ~LayerMask(0);
+}
+
+namespace Rigel::Backend
+{
+    /**
+     * Keeps a list of game objects per tag and per layer for a single scene.
+     *
+     * Lists are unordered, objects are removed by moving the last object of the list into their place.
+     * Every object remembers its position in each list it belongs to, so adding and removing tags is O(1)
+     * and the members of a tag or layer can be returned as a span without any searching.
+     */
+    class TagLayerIndex
+    {
+    public:
+        TagLayerIndex() = default;
+        ~TagLayerIndex() = default;
+
+        TagLayerIndex(const TagLayerIndex&) = delete;
+        TagLayerIndex& operator = (const TagLayerIndex&) = delete;
+
+        // Adds the object to the lists of all of its tags and its layer
+        void Add(GameObject* go);
+        void Remove(GameObject* go);
+
+        // Update the tags and the layer of an object that was already added, arguments are not validated
+        void AddTag(GameObject* go, const uint32_t tag);
+        void RemoveTag(GameObject* go, const uint32_t tag);
+        void SetLayer(GameObject* go, const uint32_t layer);
+
+        NODISCARD std::span<const GOHandle> GetTagMembers(const uint32_t tag) const { return m_TagMembers[tag]; }
+        NODISCARD std::span<const GOHandle> GetLayerMembers(const uint32_t layer) const { return m_LayerMembers[layer]; }
+    private:
+        // Position of the tag among the tags set on the object, which is where the object stores its list slot
+        NODISCARD static uint32_t GetTagRank(const GameObject* go, const uint32_t tag);
+
+        void EraseTagMember(GameObject* go, const uint32_t tag); // Leaves the tag bit of the object untouched
+        void AddToLayer(GameObject* go);
+        void RemoveFromLayer(GameObject* go);
+
+        std::array<std::vector<GOHandle>, MAX_TAGS> m_TagMembers;
+        std::array<std::vector<GOHandle>, MAX_LAYERS> m_LayerMembers;
+    };
+}
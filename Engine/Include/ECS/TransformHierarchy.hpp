@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Math.hpp"
+#include "Handles/ComponentHandle.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace Rigel
+{
+    class Transform;
+    class JobSystem;
+}
+
+namespace Rigel::Backend
+{
+    /**
+     * Owns the transform data of all Transform components of a scene.
+     *
+     * Data is stored as a structure of arrays ordered by hierarchy depth, so that every parent precedes its children.
+     * This allows world matrices to be propagated with a single linear pass per frame, one depth level at a time,
+     * where every entry of a level can be processed in parallel.
+     *
+     * Structural changes (adding, removing and reparenting entries) only mark the order as invalid,
+     * the arrays are re-sorted at the beginning of the next propagation pass.
+     * Indices of entries change when that happens, Transform components are notified through their owner pointer.
+     *
+     * Every entry carries a change version, set whenever its world matrix gets recomputed. Versions come from
+     * a counter shared by all hierarchies, so a (component ID, version) pair never refers to two different states.
+     */
+    class TransformHierarchy
+    {
+    public:
+        static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+        TransformHierarchy() = default;
+        ~TransformHierarchy() = default;
+
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator = (const TransformHierarchy&) = delete;
+
+        NODISCARD uint32_t Add(Transform* owner, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+        void Remove(const uint32_t index);
+
+        // Makes room for count more entries, used when many transforms are added at once
+        void Reserve(const size_t count);
+
+        // Pass NO_PARENT to make the entry a root
+        void SetParent(const uint32_t index, const uint32_t parentIndex);
+
+        NODISCARD const glm::vec3& GetLocalPosition(const uint32_t index) const { return m_LocalPositions[index]; }
+        NODISCARD const glm::quat& GetLocalRotation(const uint32_t index) const { return m_LocalRotations[index]; }
+        NODISCARD const glm::vec3& GetLocalScale(const uint32_t index) const { return m_LocalScales[index]; }
+
+        void SetLocalPosition(const uint32_t index, const glm::vec3& position) { m_LocalPositions[index] = position; MarkDirty(index); }
+        void SetLocalRotation(const uint32_t index, const glm::quat& rotation) { m_LocalRotations[index] = rotation; MarkDirty(index); }
+        void SetLocalScale(const uint32_t index, const glm::vec3& scale) { m_LocalScales[index] = scale; MarkDirty(index); }
+
+        NODISCARD glm::mat4 GetLocalMatrix(const uint32_t index) const;
+
+        /**
+         * Returns the world matrix of the entry. If the entry or any of its ancestors changed since the last
+         * propagation pass, the matrix is computed on demand without modifying the hierarchy.
+         */
+        NODISCARD glm::mat4 GetWorldMatrix(const uint32_t index) const;
+
+        /**
+         * Recomputes world matrices of all entries whose local transform or any ancestor changed since the last call.
+         * @param jobs Used to process large depth levels in parallel, may be nullptr
+         */
+        void Update(JobSystem* jobs);
+
+        // Version of the last propagation pass that changed the world matrix of the entry
+        NODISCARD uint64_t GetChangeVersion(const uint32_t index) const { return m_Versions[index]; }
+
+        // Transforms whose world matrix was recomputed by the last Update call, in hierarchy order
+        NODISCARD const std::vector<ComponentHandle<Transform>>& GetChangedTransforms() const { return m_ChangedTransforms; }
+
+        NODISCARD size_t GetSize() const { return m_Owners.size() - m_RemovedCount; }
+    private:
+        void MarkDirty(const uint32_t index)
+        {
+            m_LocalDirty[index] = 1;
+            m_AnyDirty.store(true, std::memory_order_relaxed);
+        }
+
+        // Restores depth order and compacts removed entries, updates hierarchy indices of the owners
+        void Rebuild();
+
+        NODISCARD uint32_t GetAliveParent(const uint32_t index) const
+        {
+            const auto parent = m_Parents[index];
+            return parent != NO_PARENT && m_Owners[parent] ? parent : NO_PARENT;
+        }
+
+        NODISCARD bool IsWorldMatrixValid(uint32_t index) const;
+        NODISCARD glm::mat4 ComposeLocalMatrix(const uint32_t index) const;
+
+        std::vector<Transform*> m_Owners; // nullptr for removed entries awaiting compaction
+        std::vector<uint32_t> m_Parents;
+
+        std::vector<glm::vec3> m_LocalPositions;
+        std::vector<glm::quat> m_LocalRotations;
+        std::vector<glm::vec3> m_LocalScales;
+
+        std::vector<glm::mat4> m_LocalMatrices;
+        std::vector<glm::mat4> m_WorldMatrices;
+
+        std::vector<uint8_t> m_LocalDirty; // Local transform changed, local and world matrices must be recomputed
+        std::vector<uint8_t> m_WorldDirty; // Only used during Update, world matrix is being recomputed this pass
+        std::vector<uint64_t> m_Versions;
+
+        std::vector<ComponentHandle<Transform>> m_ChangedTransforms;
+
+        // Entries of depth level L occupy the range [m_LevelOffsets[L], m_LevelOffsets[L + 1])
+        std::vector<uint32_t> m_LevelOffsets{0};
+
+        bool m_OrderDirty = false;
+        size_t m_RemovedCount = 0;
+        std::atomic<bool> m_AnyDirty = false; // Set from setters which may run on worker threads
+    };
+}
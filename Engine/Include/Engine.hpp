@@ -21,8 +21,9 @@ namespace Rigel
     class WindowManager;
     class InputManager;
     class PhysicsEngine;
+    class SystemScheduler;
 
-    class ThreadPool;
+    class JobSystem;
 
     class Engine final
     {
@@ -56,6 +57,7 @@ namespace Rigel
         NODISCARD Ref<WindowManager> GetWindowManager() const;
         NODISCARD Ref<InputManager> GetInputManager() const;
         NODISCARD Ref<PhysicsEngine> GetPhysicsEngine() const;
+        NODISCARD Ref<SystemScheduler> GetSystemScheduler() const;
 
         NODISCARD bool Running() const { return m_Running; }
 
@@ -78,6 +80,7 @@ namespace Rigel
         std::unique_ptr<InputManager> m_InputManager;
         std::unique_ptr<Renderer> m_Renderer;
         std::unique_ptr<PhysicsEngine> m_PhysicsEngine;
+        std::unique_ptr<SystemScheduler> m_SystemScheduler;
 
         inline static Engine* s_Instance = nullptr;
 
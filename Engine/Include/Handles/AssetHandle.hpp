@@ -4,62 +4,119 @@
 #include "RigelHandle.hpp"
 #include "Subsystems/AssetManager/AssetDeleter.hpp"
 
-#include <memory>
-
 namespace Rigel
 {
     class RigelAsset;
 
+    /**
+     * Reference counted handle to an asset.
+     *
+     * The reference count is stored in the asset itself, so every handle to the same asset shares it no matter
+     * how the handle was obtained. Non-persistent assets are unloaded when the last handle to them is destroyed.
+     */
     template<typename T> requires std::is_base_of_v<RigelAsset, T>
-    class AssetHandle final : public RigelHandle<T>
+    class AssetHandle final : public RigelHandle<T, Backend::HandleValidation::HandleType::AssetHandle>
     {
+        using Base = RigelHandle<T, Backend::HandleValidation::HandleType::AssetHandle>;
     public:
-        NODISCARD const char* GetTypeName() const override
+        NODISCARD const char* GetTypeName() const
         {
-            return TypeUtility::GetTypeName<AssetHandle>().c_str();
+            static const auto name = TypeUtility::GetTypeName<AssetHandle>();
+            return name.c_str();
         }
 
-        AssetHandle() noexcept
-            : RigelHandle<T>(nullptr, NULL_ID), m_RefCounter(nullptr) { }
+        AssetHandle() noexcept : Base() { }
 
-        AssetHandle(T* ptr, const uid_t id, const std::shared_ptr<Backend::AssetDeleter>& refCounter) noexcept
-            : RigelHandle<T>(ptr, id), m_RefCounter(refCounter) { }
+        AssetHandle(T* ptr, const uid_t id) noexcept : Base(ptr, id)
+        {
+            Retain();
+        }
 
-        ~AssetHandle() override = default;
+        AssetHandle(const AssetHandle& other) noexcept : Base(other.m_Object, other.m_ID, other.m_Slot)
+        {
+            Retain();
+        }
 
-        T* operator -> () override
+        AssetHandle(AssetHandle&& other) noexcept : Base(other.m_Object, other.m_ID, other.m_Slot)
         {
-            this->CheckHandle();
-            return this->m_Ptr;
+            other.m_Object = nullptr;
+            other.m_Slot = {};
+            other.m_ID = NULL_ID;
+        }
+
+        AssetHandle& operator = (const AssetHandle& other) noexcept
+        {
+            if (this != &other)
+            {
+                // Retain first, releasing might unload the asset if both handles point to it
+                auto copy = other;
+                Swap(copy);
+            }
+
+            return *this;
+        }
+
+        AssetHandle& operator = (AssetHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                auto moved = std::move(other);
+                Swap(moved);
+            }
+
+            return *this;
         }
 
-        const T* operator -> () const override
+        ~AssetHandle()
         {
-            this->CheckHandle();
-            return this->m_Ptr;
+            Release();
         }
 
         template<typename castT>
         NODISCARD AssetHandle<castT> Cast() const
         {
             static_assert(std::is_base_of_v<RigelAsset, castT>, "T must derive from Rigel::RigelAsset");
-            return {static_cast<castT*>(this->m_Ptr), this->m_ID, this->m_RefCounter};
+            return AssetHandle<castT>(this->m_Object, this->m_ID, this->m_Slot);
         }
 
         NODISCARD AssetHandle<RigelAsset> ToGeneric() const
         {
-            return this->Cast<RigelAsset>();
+            return this->template Cast<RigelAsset>();
         }
 
-        NODISCARD static AssetHandle Null() { return {nullptr, NULL_ID, nullptr}; }
-        NODISCARD bool IsNull() const override { return this->m_Ptr == nullptr || this->m_ID == NULL_ID || this->m_RefCounter == nullptr; }
-        NODISCARD bool IsValid() const override
+        NODISCARD static AssetHandle Null() { return AssetHandle(); }
+    private:
+        AssetHandle(RigelObject* object, const uid_t id, const Backend::HandleValidation::HandleSlot slot) noexcept
+            : Base(object, id, slot)
         {
-            using namespace Backend::HandleValidation;
-            return HandleValidator::Validate<HandleType::AssetHandle>(this->GetID());
+            Retain();
         }
-    private:
-        std::shared_ptr<Backend::AssetDeleter> m_RefCounter;
+
+        // Assets that were already unloaded are not touched, their memory might be gone
+        void Retain() const
+        {
+            if (this->IsValid())
+                Backend::AssetDeleter::AddReference(static_cast<RigelAsset*>(this->m_Object));
+        }
+
+        void Release()
+        {
+            if (this->IsValid())
+                Backend::AssetDeleter::RemoveReference(static_cast<RigelAsset*>(this->m_Object));
+
+            this->m_Object = nullptr;
+            this->m_Slot = {};
+            this->m_ID = NULL_ID;
+        }
+
+        void Swap(AssetHandle& other) noexcept
+        {
+            std::swap(this->m_Object, other.m_Object);
+            std::swap(this->m_Slot, other.m_Slot);
+            std::swap(this->m_ID, other.m_ID);
+        }
+
+        template<typename U> requires std::is_base_of_v<RigelAsset, U> friend class AssetHandle;
     };
 
     using GenericAssetHandle = AssetHandle<RigelAsset>;
@@ -9,18 +9,24 @@ namespace Rigel
     class Component;
 
     template<typename T>
-    class ComponentHandle final : public RigelHandle<T>
+    class ComponentHandle final : public RigelHandle<T, Backend::HandleValidation::HandleType::ComponentHandle>
     {
+        using Base = RigelHandle<T, Backend::HandleValidation::HandleType::ComponentHandle>;
     public:
-        NODISCARD const char* GetTypeName() const override { return TypeUtility::GetTypeName<ComponentHandle>().c_str(); }
+        NODISCARD const char* GetTypeName() const
+        {
+            static const auto name = TypeUtility::GetTypeName<ComponentHandle>();
+            return name.c_str();
+        }
 
-        ComponentHandle() : RigelHandle<T>(nullptr, NULL_ID)
+        ComponentHandle() : Base()
         {
             // we can't use 'requires std::is_base_of_v<Component, T>' because it would make using
             // handles of type T inside T declaration impossible
             static_assert(std::is_base_of_v<Component, T>, "T must derive from Rigel::Component");
         }
-        ComponentHandle(T* ptr, const uid_t id) : RigelHandle<T>(ptr, id)
+
+        ComponentHandle(T* ptr, const uid_t id) : Base(ptr, id)
         {
             // we can't use 'requires std::is_base_of_v<Component, T>' because it would make using
             // handles of type T inside T declaration impossible
@@ -37,26 +43,22 @@ namespace Rigel
         NODISCARD ComponentHandle<castT> Cast() const
         {
             static_assert(std::is_base_of_v<Component, castT>, "T must derive from Rigel::Component");
-            return {static_cast<castT*>(this->m_Ptr), this->m_ID};
+            return ComponentHandle<castT>(this->m_Object, this->m_ID, this->m_Slot);
         }
 
         NODISCARD static ComponentHandle Null()
         {
-            return {nullptr, NULL_ID};
+            return ComponentHandle();
         }
+    private:
+        ComponentHandle(RigelObject* object, const uid_t id, const Backend::HandleValidation::HandleSlot slot)
+            : Base(object, id, slot) { }
 
-        NODISCARD bool IsNull() const override
-        {
-            return this->m_Ptr == nullptr || this->m_ID == NULL_ID;
-        }
-
-        NODISCARD bool IsValid() const override
-        {
-            using namespace Backend::HandleValidation;
-            return HandleValidator::Validate<HandleType::ComponentHandle>(this->GetID());
-        }
+        template<typename> friend class ComponentHandle;
     };
 
     // Handle to a component of any type
     using GenericComponentHandle = ComponentHandle<Component>;
+
+    static_assert(std::is_trivially_copyable_v<GenericComponentHandle> && sizeof(GenericComponentHandle) == 24, "GenericComponentHandle must stay a plain 24 byte value");
 }
@@ -7,23 +7,22 @@ namespace Rigel
 {
     class GameObject;
 
-    class GOHandle final : public RigelHandle<GameObject>
+    class GOHandle final : public RigelHandle<GameObject, Backend::HandleValidation::HandleType::GOHandle>
     {
     public:
-        NODISCARD const char* GetTypeName() const override
+        NODISCARD const char* GetTypeName() const
         {
             return "Rigel::GOHandle";
         }
 
-        GOHandle() : RigelHandle(nullptr, NULL_ID) { }
+        GOHandle() = default;
         GOHandle(GameObject* ptr, const uid_t id);
 
         NODISCARD static GOHandle Null()
         {
-            return {nullptr, NULL_ID};
+            return GOHandle();
         }
-
-        NODISCARD bool IsNull() const override;
-        NODISCARD bool IsValid() const override;
     };
+
+    static_assert(std::is_trivially_copyable_v<GOHandle> && sizeof(GOHandle) == 24, "GOHandle must stay a plain 24 byte value");
 }
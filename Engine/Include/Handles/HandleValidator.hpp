@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Core.hpp"
-#include "RigelHandle.hpp"
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
+#include <vector>
 
 namespace Rigel::Backend::HandleValidation
 {
@@ -27,40 +29,166 @@ namespace Rigel::Backend::HandleValidation
                val < static_cast<uint32_t>(HandleType::MaxValue);
     }
 
-    class HandleValidator
+    /**
+     * Identifies an object in a HandleSlotTable. A slot is alive as long as its generation
+     * matches the generation stored in the table, freeing a slot bumps the stored generation,
+     * which invalidates every copy of the old slot at once.
+     */
+    struct HandleSlot
+    {
+        uint32_t Index = 0;
+        uint32_t Generation = 0; // Generation 0 is never alive, so a default constructed slot is always invalid
+    };
+
+    /**
+     * Paged table of slot generations.
+     *
+     * Pages are allocated on demand and never moved or freed while the table is alive, so Validate is a lock-free
+     * array load and compare that is safe to call from any thread.
+     * Allocating and freeing slots is guarded by a mutex.
+     */
+    class HandleSlotTable
     {
     public:
-        template<HandleType hT>
-        static void AddHandle(const uid_t handle)
+        static constexpr uint32_t PAGE_SIZE = 4096;
+        static constexpr uint32_t MAX_PAGES = 4096;
+
+        HandleSlotTable() = default;
+        ~HandleSlotTable()
         {
-            static_assert(IS_HANDLE_TYPE_VALID<hT>());
-            if (handle == NULL_ID) return;
+            // Objects outliving the table must see their slots as invalid instead of reading freed pages
+            for (auto& page : m_Pages)
+                delete[] page.exchange(nullptr, std::memory_order_acq_rel);
+        }
+
+        HandleSlotTable(const HandleSlotTable&) = delete;
+        HandleSlotTable& operator = (const HandleSlotTable&) = delete;
 
+        NODISCARD HandleSlot Allocate()
+        {
             std::unique_lock lock(m_Mutex);
-            m_ValidHandles[static_cast<uint32_t>(hT)].insert(handle);
+            return AllocateUnlocked();
         }
 
-        template<HandleType hT>
-        static void RemoveHandle(const uid_t handle)
+        // Allocates a slot for every element of the span while taking the lock only once
+        void Allocate(const std::span<HandleSlot> slots)
         {
-            static_assert(IS_HANDLE_TYPE_VALID<hT>());
-            if (handle == NULL_ID) return;
+            std::unique_lock lock(m_Mutex);
+
+            for (auto& slot : slots)
+                slot = AllocateUnlocked();
+        }
 
+        void Free(const HandleSlot slot)
+        {
             std::unique_lock lock(m_Mutex);
-            m_ValidHandles[static_cast<uint32_t>(hT)].erase(handle);
+
+            if (!Validate(slot))
+                return;
+
+            // Skips generation 0 on wrap around, it is reserved for invalid slots
+            auto nextGeneration = slot.Generation + 1;
+            if (nextGeneration == 0)
+                nextGeneration = 1;
+
+            m_Pages[slot.Index / PAGE_SIZE].load(std::memory_order_relaxed)[slot.Index % PAGE_SIZE].store(nextGeneration, std::memory_order_release);
+            m_FreeIndices.push_back(slot.Index);
         }
 
-        template<HandleType hT>
-        NODISCARD static bool Validate(const uid_t handle)
+        NODISCARD bool Validate(const HandleSlot slot) const
+        {
+            if (slot.Generation == 0 || slot.Index >= PAGE_SIZE * MAX_PAGES)
+                return false;
+
+            const auto page = m_Pages[slot.Index / PAGE_SIZE].load(std::memory_order_acquire);
+            return page && page[slot.Index % PAGE_SIZE].load(std::memory_order_acquire) == slot.Generation;
+        }
+    private:
+        NODISCARD HandleSlot AllocateUnlocked()
+        {
+            uint32_t index;
+            if (!m_FreeIndices.empty())
+            {
+                index = m_FreeIndices.back();
+                m_FreeIndices.pop_back();
+            }
+            else
+            {
+                index = m_NextIndex++;
+                ASSERT(index < PAGE_SIZE * MAX_PAGES, "Handle slot table capacity exceeded");
+
+                if (index % PAGE_SIZE == 0)
+                {
+                    const auto page = new std::atomic<uint32_t>[PAGE_SIZE];
+                    for (uint32_t i = 0; i < PAGE_SIZE; ++i)
+                        page[i].store(1, std::memory_order_relaxed);
+
+                    m_Pages[index / PAGE_SIZE].store(page, std::memory_order_release);
+                }
+            }
+
+            const auto generation = m_Pages[index / PAGE_SIZE].load(std::memory_order_relaxed)[index % PAGE_SIZE].load(std::memory_order_relaxed);
+            return {index, generation};
+        }
+
+        std::array<std::atomic<std::atomic<uint32_t>*>, MAX_PAGES> m_Pages{};
+
+        std::mutex m_Mutex;
+        std::vector<uint32_t> m_FreeIndices;
+        uint32_t m_NextIndex = 0;
+    };
+
+    /**
+     * Keeps track of which objects referenced by handles are still alive.
+     * Every object gets a HandleSlot in the table of its handle type when it is created,
+     * handles copy the slot and compare it against the table to find out whether the object was destroyed.
+     */
+    class HandleValidator
+    {
+    public:
+        // Assigns a new handle slot to the object, T must provide SetHandleSlot
+        template<HandleType hT, typename T>
+        static void AddHandle(T& object)
         {
             static_assert(IS_HANDLE_TYPE_VALID<hT>());
-            if (handle == NULL_ID) return false;
+            object.SetHandleSlot(GetTable<hT>().Allocate());
+        }
 
-            std::unique_lock lock(m_Mutex);
-            return m_ValidHandles[static_cast<uint32_t>(hT)].contains(handle);
+        // Same as calling AddHandle for every object, but the table is locked only once
+        template<HandleType hT, typename T>
+        static void AddHandles(const std::span<T*> objects)
+        {
+            static_assert(IS_HANDLE_TYPE_VALID<hT>());
+
+            auto slots = std::vector<HandleSlot>(objects.size());
+            GetTable<hT>().Allocate(slots);
+
+            for (size_t i = 0; i < objects.size(); ++i)
+                objects[i]->SetHandleSlot(slots[i]);
+        }
+
+        // Invalidates all handles to the object, T must provide GetHandleSlot and SetHandleSlot
+        template<HandleType hT, typename T>
+        static void RemoveHandle(T& object)
+        {
+            static_assert(IS_HANDLE_TYPE_VALID<hT>());
+            GetTable<hT>().Free(object.GetHandleSlot());
+            object.SetHandleSlot(HandleSlot());
+        }
+
+        template<HandleType hT>
+        NODISCARD static bool Validate(const HandleSlot slot)
+        {
+            static_assert(IS_HANDLE_TYPE_VALID<hT>());
+            return GetTable<hT>().Validate(slot);
         }
     private:
-        inline static std::unordered_map<uint32_t, std::unordered_set<uid_t>> m_ValidHandles{};
-        inline static std::mutex m_Mutex{};
+        template<HandleType hT>
+        NODISCARD static HandleSlotTable& GetTable()
+        {
+            return m_Tables[static_cast<uint32_t>(hT)];
+        }
+
+        inline static std::array<HandleSlotTable, static_cast<size_t>(HandleType::MaxValue)> m_Tables{};
     };
 }
@@ -2,56 +2,65 @@
 
 #include "Core.hpp"
 #include "Debug.hpp"
-#include "Utilities/Reflection/TypeRegistry.hpp"
+#include "RigelObject.hpp"
+#include "Handles/HandleValidator.hpp"
 
 namespace Rigel
 {
     /**
-     * Base class for handles to objects managed by Rigel engine and it's subsystems
+     * Base class for handles to objects managed by Rigel engine and it's subsystems.
+     *
+     * Handles are plain 24 byte values: a pointer to the object, the validation slot it had when the handle
+     * was created and its ID. There are no virtual functions, all access is resolved at compile time through the handle type.
      * @tparam T The type of underlying object pointer
+     * @tparam hT The slot table used to validate handles of this type
      */
-    template<typename T>
-    class RigelHandle : public ITypeRegistrable
+    template<typename T, Backend::HandleValidation::HandleType hT>
+    class RigelHandle
     {
     public:
-        ~RigelHandle() override = default;
-
-        NODISCARD const char* GetTypeName() const override = 0;
-
-        virtual T* operator -> ()
+        T* operator -> ()
         {
             CheckHandle();
-            return m_Ptr;
+            return static_cast<T*>(m_Object);
         }
 
-        virtual const T* operator -> () const
+        const T* operator -> () const
         {
             CheckHandle();
-            return m_Ptr;
+            return static_cast<const T*>(m_Object);
         }
 
+        /**
+         * Returns the ID of the object this handle was created for, it is kept after the object is destroyed.
+         */
         NODISCARD uid_t GetID() const { return m_ID; }
-    protected:
-        RigelHandle(T* ptr, const uid_t id) : m_Ptr(ptr), m_ID(id) { }
-
-        RigelHandle(const RigelHandle&) noexcept = default;
-        RigelHandle& operator = (const RigelHandle&) noexcept = default;
-        RigelHandle(RigelHandle&&) noexcept = default;
-        RigelHandle& operator = (RigelHandle&&) noexcept = default;
 
         /**
-        * Returns true if at least one of the handle members (e.g. the underlying pointer,
-        * UID or any other data specific to a certain handle type) is null.
+        * Returns true if the handle was never assigned an object.
         */
-        NODISCARD virtual bool IsNull() const = 0;
+        NODISCARD bool IsNull() const { return m_Object == nullptr || m_Slot.Generation == 0; }
 
         /**
-        * Will be false if a handle is left in an invalid state that cannot be detected by nullity.
-        *
-        * The exact conditions that can put a handle in an invalid state may vary drastically
-        * depending on its type. Validating may be costly for some types (especially so for Rigel::Component and Rigel::GameObject)
+        * Will be false if the object the handle points to has been destroyed, which cannot be detected by nullity.
+        * Validating is a lock-free array load and compare.
         */
-        NODISCARD virtual bool IsValid() const = 0;
+        NODISCARD bool IsValid() const
+        {
+            return m_Object != nullptr && Backend::HandleValidation::HandleValidator::Validate<hT>(m_Slot);
+        }
+    protected:
+        RigelHandle() = default;
+
+        // T must be complete here, the handle copies the validation slot of the object it points to
+        RigelHandle(T* ptr, const uid_t id) : m_Object(ptr), m_ID(id)
+        {
+            if (ptr)
+                m_Slot = m_Object->GetHandleSlot();
+        }
+
+        RigelHandle(RigelObject* object, const uid_t id, const Backend::HandleValidation::HandleSlot slot)
+            : m_Object(object), m_Slot(slot), m_ID(id) { }
 
         void CheckHandle() const
         {
@@ -68,7 +77,9 @@ namespace Rigel
             #endif
         }
 
-        T* m_Ptr = nullptr;
+        // Stored as the base type, so that copying and validating handles never requires T to be complete
+        RigelObject* m_Object = nullptr;
+        Backend::HandleValidation::HandleSlot m_Slot{};
         uid_t m_ID = NULL_ID;
     };
 }
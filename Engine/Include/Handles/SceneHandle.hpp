@@ -7,23 +7,22 @@ namespace Rigel
 {
     class Scene;
 
-    class SceneHandle final : public RigelHandle<Scene>
+    class SceneHandle final : public RigelHandle<Scene, Backend::HandleValidation::HandleType::SceneHandle>
     {
     public:
-        NODISCARD const char* GetTypeName() const override
+        NODISCARD const char* GetTypeName() const
         {
             return "Rigel::SceneHandle";
         }
 
-        SceneHandle() : RigelHandle(nullptr, NULL_ID) { }
+        SceneHandle() = default;
         SceneHandle(Scene* ptr, const uid_t id);
 
         NODISCARD static SceneHandle Null()
         {
-            return {nullptr, NULL_ID};
+            return SceneHandle();
         }
-
-        NODISCARD bool IsNull() const override;
-        NODISCARD bool IsValid() const override;
     };
+
+    static_assert(std::is_trivially_copyable_v<SceneHandle> && sizeof(SceneHandle) == 24, "SceneHandle must stay a plain 24 byte value");
 }
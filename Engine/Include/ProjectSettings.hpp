@@ -37,16 +37,22 @@ namespace Rigel
         std::string WindowTitle = "None";
         bool WindowResizeable = true;
 
-        // Tags and Layers
+        // Tags and Layers, IDs must be less than MAX_TAGS and MAX_LAYERS respectively
         std::map<uid_t, std::string> TagsMap = {
             {0, "Default"},
             {1, "Main Camera"}
         };
+        std::map<uid_t, std::string> LayersMap = {
+            {0, "Default"}
+        };
 
         // Assets and asset manager
         uint32_t AssetManagerThreadPoolSize = 4; // set to 0 for std::thread::hardware_concurrency()
         bool EnableAssetLifetimeLogging = true;
 
+        // Gameplay systems
+        uint32_t SystemSchedulerThreadPoolSize = 0; // set to 0 for std::thread::hardware_concurrency()
+
         NODISCARD nlohmann::json Serialize() const override
         {
             return { };
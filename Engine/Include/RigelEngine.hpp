@@ -28,6 +28,7 @@
 #include "Subsystems/AssetManager/AssetManager.hpp"
 #include "Subsystems/WindowManager/WindowManager.hpp"
 #include "Subsystems/PhysicsEngine/PhysicsEngine.hpp"
+#include "Subsystems/SystemScheduler/SystemScheduler.hpp"
 #include "Subsystems/SubsystemGetters.hpp"
 
 // Subsystem-related classes
@@ -73,7 +74,8 @@
 
 // Utility
 #include "Utilities/Reflection/TypeUtility.hpp"
-#include "Utilities/Threading/ThreadPool.hpp"
+#include "Utilities/Threading/JobSystem.hpp"
+#include "Utilities/Threading/Parallel.hpp"
 #include "Utilities/Threading/SleepUtility.hpp"
 #include "Utilities/Serialization/ISerializable.hpp"
 #include "Utilities/Serialization/Serializer.hpp"
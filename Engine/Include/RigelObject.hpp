@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core.hpp"
+#include "Handles/HandleValidator.hpp"
 
 namespace Rigel
 {
@@ -17,10 +18,18 @@ namespace Rigel
         NODISCARD uid_t GetID() const { return m_ID; }
     INTERNAL:
         void OverrideID(const uid_t id) { m_ID = id; }
+
+        // The slot used to validate handles to this object, see HandleValidator
+        NODISCARD Backend::HandleValidation::HandleSlot GetHandleSlot() const { return m_HandleSlot; }
+        void SetHandleSlot(const Backend::HandleValidation::HandleSlot slot) { m_HandleSlot = slot; }
     protected:
         explicit RigelObject(const uid_t id) : m_ID(id) { }
         virtual ~RigelObject() = default;
     private:
         uid_t m_ID = NULL_ID;
+        Backend::HandleValidation::HandleSlot m_HandleSlot{};
+
+        template<typename, Backend::HandleValidation::HandleType> friend class RigelHandle;
+        friend class Backend::HandleValidation::HandleValidator; // Called from inline constructors of client-side objects
     };
 }
@@ -5,12 +5,11 @@
 
 namespace Rigel::Backend
 {
+    // Maintains the reference counts of assets, unloading non-persistent assets once nothing references them
     class AssetDeleter
     {
     public:
-        explicit AssetDeleter(RigelAsset* ptr);
-        ~AssetDeleter();
-    private:
-        RigelAsset* m_Asset;
+        static void AddReference(RigelAsset* asset);
+        static void RemoveReference(RigelAsset* asset);
     };
-}
\ No newline at end of file
+}
@@ -7,8 +7,10 @@
 #include "Assets/RigelAsset.hpp"
 #include "Assets/Metadata/AssetMetadata.hpp"
 #include "Subsystems/RigelSubsystem.hpp"
+#include "Subsystems/SubsystemGetters.hpp"
+#include "Subsystems/EventSystem/EventManager.hpp"
 #include "Utilities/ScopeGuard.hpp"
-#include "Utilities/Threading/ThreadPool.hpp"
+#include "Utilities/Threading/JobSystem.hpp"
 
 #include <memory>
 #include <atomic>
@@ -76,12 +78,16 @@ namespace Rigel
 
             auto loadFinishedGuard = ScopeGuard([rawPtr]
             {
+                // Read before waking up waiters, the asset may be unloaded as soon as it's marked as finished
+                const auto loadedEvent = AssetLoadedEvent(rawPtr->GetID(), rawPtr->IsInitialized());
+
                 {
                     std::unique_lock lock(rawPtr->m_CvMutex);
                     rawPtr->m_LoadFinished = true;
                 }
 
                 rawPtr->m_CV.notify_one();
+                GetEventManager()->Post(loadedEvent);
             });
 
             if (const auto result = rawPtr->Init(); result != ErrorCode::OK)
@@ -112,7 +118,8 @@ namespace Rigel
          * @param path Filesystem path to the asset.
          * @param persistent If true, the asset will not be automatically deleted when its reference count reaches 0.
          * @return AssetHandle<T> Handle to the asset. You can check `.IsReady()` to check if the asset is loaded.
-         * You can use `.WaitReady()` to stall until the loading is finished.
+         * You can use `.WaitReady()` to stall until the loading is finished, or subscribe to AssetLoadedEvent,
+         * which is posted once the loading is finished.
          */
         template<RigelAssetConcept T>
         AssetHandle<T> LoadAsync(const std::filesystem::path& path, const bool persistent = false)
@@ -142,16 +149,19 @@ namespace Rigel
                 m_Registry[pathHash] = std::move(entry);
             }
 
-            m_ThreadPool->Enqueue([this, rawPtr, path]
+            m_JobSystem->Schedule([this, rawPtr, path]
             {
                 auto loadFinishedGuard = ScopeGuard([rawPtr]
                 {
+                    const auto loadedEvent = AssetLoadedEvent(rawPtr->GetID(), rawPtr->IsInitialized());
+
                     {
                         std::unique_lock lock(rawPtr->m_CvMutex);
                         rawPtr->m_LoadFinished = true;
                     }
 
                     rawPtr->m_CV.notify_one();
+                    GetEventManager()->Post(loadedEvent);
                 });
 
                 if (const auto result = rawPtr->Init(); result != ErrorCode::OK)
@@ -216,7 +226,10 @@ namespace Rigel
         ErrorCode Startup(const ProjectSettings& settings) override;
         ErrorCode Shutdown() override;
 
-        NODISCARD const std::vector<std::thread::id>& GetLoadingThreadsIDs() const { return m_ThreadPool->GetThreadsIDs(); }
+        NODISCARD const std::vector<std::thread::id>& GetLoadingThreadsIDs() const { return m_JobSystem->GetThreadsIDs(); }
+
+        // Assets may use it to process their data in parallel while loading
+        NODISCARD JobSystem& GetJobSystem() const { return *m_JobSystem; }
 
         void UnloadAllAssets();
     private:
@@ -237,7 +250,7 @@ namespace Rigel
         template<RigelAssetConcept T>
         static AssetHandle<T> MakeHandle(const AssetRegistryEntry& entry)
         {
-            return AssetHandle<T>(static_cast<T*>(entry.Asset.get()), entry.AssetID, std::make_shared<Backend::AssetDeleter>(entry.Asset.get()));
+            return AssetHandle<T>(static_cast<T*>(entry.Asset.get()), entry.AssetID);
         }
 
         template<RigelAssetConcept T>
@@ -255,6 +268,6 @@ namespace Rigel
         mutable std::shared_mutex m_MetadataMutex;
 
         bool m_EnableAssetLifetimeLogging = true;
-        std::unique_ptr<ThreadPool> m_ThreadPool;
+        std::unique_ptr<JobSystem> m_JobSystem;
     };
 }
@@ -105,4 +105,17 @@ namespace Rigel
     {
 
     };
+
+    /**
+     * Posted by AssetManager when loading of an asset finished, successfully or not.
+     * Delivered on the main thread at the beginning of the next frame, compare AssetID with IDs of asset handles
+     * to find out which asset it is, e.g. instead of polling IsReady every frame.
+     */
+    struct AssetLoadedEvent final : public Event
+    {
+        AssetLoadedEvent(const uid_t assetID, const bool success) : AssetID(assetID), Success(success) { }
+
+        uid_t AssetID;
+        bool Success;
+    };
 }
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "Utilities/Reflection/TypeID.hpp"
+
 namespace Rigel
 {
     struct Event
     {
         virtual ~Event() = default;
     };
+
+    // Dense IDs of event types, used to index event subscribers
+    using EventTypeID = TypeID<Event>;
 }
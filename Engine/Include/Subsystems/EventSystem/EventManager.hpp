@@ -5,12 +5,15 @@
 #include "Event.hpp"
 #include "EngineEvents.hpp"
 #include "Subsystems/RigelSubsystem.hpp"
-#include "Utilities/Threading/ThreadPool.hpp"
+#include "Utilities/Delegate.hpp"
+#include "Utilities/Threading/JobSystem.hpp"
 
 #include <algorithm>
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <new>
 #include <unordered_map>
-#include <typeindex>
 #include <vector>
 
 namespace Rigel
@@ -25,25 +28,24 @@ namespace Rigel
     {
     public:
         using CallbackID = uid_t;
+        using Callback = Delegate<void(const Event&)>;
 
         /**
          * Subscribe a callback function to an event of type EventType
-         * NOTE: This overload only supports lambdas and free functions
+         * NOTE: This overload only supports lambdas and free functions. Callbacks are stored without allocations,
+         * so lambdas may capture at most two pointers, see Rigel::Delegate
          * @tparam EventType The type of event to subscribe to
          * @param callback The event callback function
          * @return A unique event callback ID, you can use it to unsubscribe the callback
          */
-        template<EventTypeConcept EventType>
-        CallbackID Subscribe(const std::function<void(const EventType&)>& callback)
+        template<EventTypeConcept EventType, typename F> requires std::is_invocable_v<const F&, const EventType&>
+        CallbackID Subscribe(const F& callback)
         {
-            const auto id = m_NextCallbackID++;
-            auto wrapper = [callback](const Event& event) {
-                callback(static_cast<const EventType&>(event));
-            };
-
-            m_Subscribers[TYPE_INDEX(EventType)].emplace_back(id, wrapper);
-            m_SuspendTable[id] = false;
-            return id;
+            return AddSubscriber(EventTypeID::Get<EventType>(), Callback::Bind(callback, nullptr,
+                [](void*, const Callback::Storage& storage, const Event& event)
+                {
+                    storage.As<F>()(static_cast<const EventType&>(event));
+                }));
         }
 
         /**
@@ -59,41 +61,33 @@ namespace Rigel
         template<EventTypeConcept EventType, typename T>
         CallbackID Subscribe(T* instance, void (T::*memberFunc)(const EventType&))
         {
-            const auto id = m_NextCallbackID++;
-            auto wrapper = [instance, memberFunc](const Event& event) {
-                (instance->*memberFunc)(static_cast<const EventType&>(event));
-            };
-
-            m_Subscribers[TYPE_INDEX(EventType)].emplace_back(id, wrapper);
-            m_SuspendTable[id] = false;
+            using Method = void (T::*)(const EventType&);
 
-            return id;
+            return AddSubscriber(EventTypeID::Get<EventType>(), Callback::Bind(memberFunc, instance,
+                [](void* object, const Callback::Storage& storage, const Event& event)
+                {
+                    (static_cast<T*>(object)->*storage.As<Method>())(static_cast<const EventType&>(event));
+                }));
         }
 
+        // Callbacks of components are skipped while the component is not active in the hierarchy,
+        // so activating and deactivating components doesn't have to suspend them one by one
         template<typename T> requires std::is_base_of_v<Component, T>
-        CallbackID Subscribe(const std::type_index typeIndex, T* instance, void (T::*memberFunc)())
+        CallbackID Subscribe(const type_id_t eventTypeID, T* instance, void (T::*memberFunc)())
         {
-            const auto id = m_NextCallbackID++;
-            auto wrapper = [instance, memberFunc](const Event&) {
-                (instance->*memberFunc)();
-            };
-
-            m_Subscribers[typeIndex].emplace_back(id, wrapper);
-            m_SuspendTable[id] = false;
+            using Method = void (T::*)();
 
-            return id;
+            return AddSubscriber(eventTypeID, Callback::Bind(memberFunc, instance,
+                [](void* object, const Callback::Storage& storage, const Event&)
+                {
+                    const auto component = static_cast<T*>(object);
+                    if (component->IsActiveInHierarchy())
+                        (component->*storage.As<Method>())();
+                }));
         }
 
-        void SetSuspend(const CallbackID id, const bool state)
-        {
-            if (!m_SuspendTable.contains(id))
-            {
-                Debug::Error("Attempted to suspend an event callback with invalid ID {}!", id);
-                return;
-            }
-
-            m_SuspendTable[id] = state;
-        }
+        // Suspended callbacks stay subscribed but are skipped by Dispatch
+        void SetSuspend(const CallbackID id, const bool state);
 
         /**
          * @brief Unsubscribes a previously registered callback from an event of type EventType.
@@ -109,94 +103,105 @@ namespace Rigel
         {
             if (id == NULL_ID) return;
 
-            Unsubscribe(TYPE_INDEX(EventType), id);
+            Unsubscribe(EventTypeID::Get<EventType>(), id);
         }
 
         /**
          * @brief Unsubscribes a previously registered callback using both event type and callback ID.
          *
          * This overload is useful when the type is only known at runtime (e.g., from a registry).
-         * If the given CallbackID is invalid (NULL_ID), the call is ignored.
+         * If the given CallbackID is invalid (NULL_ID), the call is ignored. Takes constant time,
+         * callbacks may unsubscribe themselves and each other while their event is being dispatched.
          *
-         * @param type The type index of the event to unsubscribe from.
+         * @param eventTypeID The EventTypeID of the event to unsubscribe from.
          * @param id The unique ID of the callback to remove.
          */
-        void Unsubscribe(const std::type_index type, const CallbackID id)
-        {
-            if (id == NULL_ID) return;
-
-            if (const auto it = m_Subscribers.find(type); it != m_Subscribers.end())
-            {
-                auto& vec = it->second;
-                std::erase_if(vec, [id](const auto& pair) { return pair.first == id; });
-            }
-
-            m_SuspendTable.erase(id);
-        }
+        void Unsubscribe(const type_id_t eventTypeID, const CallbackID id);
 
         /**
          * @brief Dispatches an event to all registered callbacks for the given event type on the calling thread.
+         * Callbacks subscribed while the event is being dispatched are first called by the next dispatch.
          * @tparam EventType The concrete event type to dispatch.
          * @param event The event instance to pass to all subscribers.
          */
         template<EventTypeConcept EventType>
         void Dispatch(const EventType& event)
         {
-            auto it = m_Subscribers.find(typeid(EventType));
-            if (it != m_Subscribers.end())
+            const auto typeID = EventTypeID::Get<EventType>();
+            if (typeID >= m_Subscribers.size())
+                return;
+
+            // The list itself never moves, but callbacks may subscribe new ones, which can reallocate its arrays.
+            // The arrays are indexed on every iteration and the callback is copied out before it is called.
+            auto& subscribers = m_Subscribers[typeID];
+            const auto count = subscribers.GetSize();
+
+            ++subscribers.DispatchDepth;
+
+            for (size_t i = 0; i < count; ++i)
             {
-                for (const auto& [id, callback] : it->second)
-                {
-                    if (!m_SuspendTable.at(id))
-                        callback(event);
-                }
+                if (subscribers.IsSuspended(i))
+                    continue;
+
+                const auto thunk = subscribers.Thunks[i];
+                const auto instance = subscribers.Instances[i];
+                const auto storage = subscribers.Storages[i];
+                thunk(instance, storage, event);
             }
+
+            EndDispatch(subscribers);
         }
 
         /**
-         * Executes an event of 'EventType' on a thread pool. All subscriber functions are grouped to avoid Enqueue overhead.
-         * Assumes that all subscriber functions are atomic.
-         * Blocks the calling thread until all event subscribers have been dispatched.
-         * @tparam EventType The type of the event that will be dispatched
-         * @param pool The thread pool that will be used to dispatch the event subscribers
-         * @param event An event that will be dispatched on a thread pool
-         * @param groups How many groups all the event subscribers will be divided to. Each group
-         * guaranteed to be executed a separate thread.
+         * Queues a copy of the event to be dispatched on the main thread. Unlike the rest of the
+         * EventManager this method is thread-safe and lock-free, use it to raise events from worker threads.
+         *
+         * Posted events are delivered once per frame, right after window events are polled. Delivery is grouped
+         * by event type, events of the same type are delivered in the order they were posted. Events posted
+         * during delivery are delivered in the next frame.
+         * @tparam EventType The type of the event, must not be over-aligned
+         * @param event The event to copy into the queue
          */
         template<EventTypeConcept EventType>
-        void DispatchThreaded(const EventType& event, ThreadPool& pool, const size_t groups)
+        void Post(const EventType& event)
         {
-            ASSERT(groups <= pool.GetSize(), "The number of threaded dispatch task groups must be less than the number of threads in the pool");
+            static_assert(alignof(EventType) <= alignof(std::max_align_t), "Over-aligned events can't be posted");
 
-            auto futures = std::vector<std::future<void>>();
+            auto& queue = BeginPost();
 
-            auto it = m_Subscribers.find(typeid(EventType));
-            if (it != m_Subscribers.end())
+            const auto memory = queue.Allocate(POSTED_EVENT_HEADER_SIZE + sizeof(EventType));
+            const auto posted = new (memory) PostedEvent();
+            posted->EventPtr = new (memory + POSTED_EVENT_HEADER_SIZE) EventType(event);
+            posted->EventTypeID = EventTypeID::Get<EventType>();
+            posted->Deliver = [](EventManager& manager, const Event& postedEvent)
             {
-                const auto totalEvents = it->second.size();
-                const auto eventsPerThread = (totalEvents + groups - 1) / groups;
+                manager.Dispatch(static_cast<const EventType&>(postedEvent));
+            };
 
-                for (size_t workerIdx = 0; workerIdx < groups; workerIdx++)
-                {
-                    const auto startIdx = workerIdx * eventsPerThread;
-                    if (startIdx >= totalEvents) break;
-
-                    const auto endIdx = std::min(startIdx + eventsPerThread, totalEvents);
-
-                    futures.emplace_back(pool.Enqueue([startIdx, endIdx, it, event, this]
-                    {
-                        for (size_t i = startIdx; i < endIdx; ++i)
-                        {
-                            const auto& [id, callback] = it->second[i];
-                            if (!m_SuspendTable.at(id))
-                                callback(event);
-                        }
-                    }));
-                }
-            }
+            EndPost(queue, posted);
+        }
 
-            for (auto& future : futures)
-                future.wait();
+        /**
+         * Executes an event of 'EventType' on a job system, the calling thread takes part in the dispatch.
+         * Subscribers are claimed in chunks that shrink as the dispatch progresses, so threads that run cheap callbacks
+         * take over the work of threads stuck on expensive ones. Small dispatches run on the calling thread only.
+         * Assumes that all subscriber functions are atomic, they must not subscribe or unsubscribe callbacks of this event type.
+         * Blocks the calling thread until all event subscribers have been dispatched.
+         * @tparam EventType The type of the event that will be dispatched
+         * @param jobs The job system that will be used to dispatch the event subscribers
+         * @param event An event that will be dispatched on a job system
+         * @param groups The maximum number of worker threads that help the calling thread
+         */
+        template<EventTypeConcept EventType>
+        void DispatchThreaded(const EventType& event, JobSystem& jobs, const size_t groups)
+        {
+            ASSERT(groups <= jobs.GetSize(), "The number of threaded dispatch task groups must be less than the number of threads in the job system");
+
+            const auto typeID = EventTypeID::Get<EventType>();
+            if (typeID >= m_Subscribers.size())
+                return;
+
+            DispatchThreaded(m_Subscribers[typeID], event, jobs, groups);
         }
     INTERNAL:
         EventManager() = default;
@@ -204,9 +209,123 @@ namespace Rigel
 
         ErrorCode Startup(const ProjectSettings& settings) override;
         ErrorCode Shutdown() override;
+
+        // Dispatches all events posted since the last call, must be called on the main thread once per frame
+        void DeliverPostedEvents();
     private:
-        std::unordered_map<std::type_index, std::vector<std::pair<CallbackID, std::function<void(const Event&)>>>> m_Subscribers{};
-        std::unordered_map<uid_t, bool> m_SuspendTable {}; // Ideally this should be optimized to use 1 bit per flag.
-        CallbackID m_NextCallbackID = 0;
+        /**
+         * Callbacks of a single event type stored as a structure of arrays, so that dispatching
+         * walks contiguous thunks and instance pointers and checks one bit per callback.
+         * Removed callbacks are replaced by the last one, which keeps the arrays dense.
+         */
+        struct SubscriberList
+        {
+            std::vector<Callback::Thunk> Thunks;
+            std::vector<void*> Instances;
+            std::vector<Callback::Storage> Storages;
+            std::vector<CallbackID> IDs;
+            std::vector<uint64_t> SuspendBits; // One bit per callback, also set for callbacks waiting for removal
+
+            // Callbacks removed during a dispatch are only suspended, they are swapped out once the dispatch ends
+            std::vector<uint32_t> PendingRemovals;
+            uint32_t DispatchDepth = 0;
+
+            NODISCARD size_t GetSize() const { return Thunks.size(); }
+
+            NODISCARD bool IsSuspended(const size_t index) const
+            {
+                return SuspendBits[index / 64] & (1ull << (index % 64));
+            }
+
+            void SetSuspended(const size_t index, const bool state)
+            {
+                if (state)
+                    SuspendBits[index / 64] |= 1ull << (index % 64);
+                else
+                    SuspendBits[index / 64] &= ~(1ull << (index % 64));
+            }
+        };
+
+        // Position of a callback, looked up by ID to unsubscribe or suspend it in constant time
+        struct CallbackLocation
+        {
+            type_id_t EventTypeID;
+            uint32_t Index;
+        };
+
+        struct PostedEvent
+        {
+            PostedEvent* Next = nullptr;
+            Event* EventPtr = nullptr; // Lives in the same allocation, right after the header
+            type_id_t EventTypeID = 0;
+            void (*Deliver)(EventManager& manager, const Event& event) = nullptr;
+        };
+
+        static constexpr size_t POSTED_EVENT_HEADER_SIZE =
+            (sizeof(PostedEvent) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        /**
+         * Events posted during one frame. Producers bump-allocate from a chain of memory blocks
+         * and push the events onto an intrusive lock-free stack, the main thread takes the whole stack at once.
+         * Memory is reused every other frame, blocks are only allocated when posted events outgrow them.
+         */
+        class PostQueue
+        {
+        public:
+            PostQueue() = default;
+            ~PostQueue();
+
+            PostQueue(const PostQueue&) = delete;
+            PostQueue& operator = (const PostQueue&) = delete;
+
+            NODISCARD byte_t* Allocate(size_t size);
+            void Push(PostedEvent* event);
+
+            // Takes all pushed events, most recently pushed first
+            NODISCARD PostedEvent* TakeAll() { return m_Head.exchange(nullptr, std::memory_order_acquire); }
+
+            // Destroys the events taken by TakeAll and makes the memory reusable, producers must not use the queue meanwhile
+            void Reset(PostedEvent* events);
+
+            std::atomic<uint32_t> Writers = 0; // Producers that picked this queue and didn't finish posting yet
+        private:
+            struct Block
+            {
+                Block* Next;
+                size_t Capacity;
+                std::atomic<size_t> Offset;
+
+                NODISCARD byte_t* GetData() { return reinterpret_cast<byte_t*>(this) + BLOCK_HEADER_SIZE; }
+            };
+
+            static void DestroyEvents(PostedEvent* events);
+            static void FreeBlocks(Block* blocks);
+
+            static constexpr size_t BLOCK_HEADER_SIZE =
+                (sizeof(Block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+            static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+            std::atomic<PostedEvent*> m_Head = nullptr;
+            std::atomic<Block*> m_Blocks = nullptr; // Most recent block first, only the first one is allocated from
+        };
+
+        // Returns the queue of the current frame, which is guaranteed to not be delivered until EndPost is called
+        NODISCARD PostQueue& BeginPost();
+        void EndPost(PostQueue& queue, PostedEvent* event);
+
+        CallbackID AddSubscriber(const type_id_t eventTypeID, const Callback& callback);
+        void RemoveSubscriber(SubscriberList& subscribers, const uint32_t index);
+        void EndDispatch(SubscriberList& subscribers);
+        void DispatchThreaded(SubscriberList& subscribers, const Event& event, JobSystem& jobs, const size_t helpers);
+
+        // Indexed by EventTypeID. A deque keeps lists in place when a new event type is subscribed during a dispatch
+        std::deque<SubscriberList> m_Subscribers{};
+        std::unordered_map<CallbackID, CallbackLocation> m_Callbacks{};
+        CallbackID m_NextCallbackID = 1; // Starts at 1 because NULL_ID callbacks are ignored by Unsubscribe
+
+        // Producers post into one queue while the other one is being delivered
+        PostQueue m_PostQueues[2];
+        std::atomic<uint32_t> m_ActivePostQueue = 0;
+        std::vector<PostedEvent*> m_DeliveryBuffer; // Reused by DeliverPostedEvents to sort events by type
     };
 }
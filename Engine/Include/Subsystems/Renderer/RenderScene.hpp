@@ -6,10 +6,12 @@
 #include "Handles/AssetHandle.hpp"
 
 #include <optional>
+#include <span>
 
 namespace Rigel
 {
     class SceneHandle;
+    class JobSystem;
 
     struct RenderCamera
     {
@@ -21,6 +23,12 @@ namespace Rigel
     {
         AssetHandle<Model> Model;
         glm::mat4 Transform;
+
+        // Identify the world matrix state, data derived from Transform can be reused while all of them stay the same.
+        // Object IDs are only unique within a scene, so the scene ID is needed as well
+        uid_t SceneID;
+        uid_t TransformID;
+        uint64_t TransformVersion;
     };
 
     struct RenderDirectionalLight
@@ -64,7 +72,9 @@ namespace Rigel
     class RenderScene
     {
     public:
-        NODISCARD static RenderScene Extract(const SceneHandle& scene);
+        // The camera is taken from the first scene that has one, models and lights from all scenes.
+        // Visible models are checked in parallel on the job system, their order doesn't depend on the number of threads
+        NODISCARD static RenderScene Extract(std::span<const SceneHandle> scenes, JobSystem& jobs);
 
         std::optional<RenderCamera> Camera;
         std::vector<RenderModel> Models;
@@ -2,11 +2,16 @@
 
 #include "RigelSubsystem.hpp"
 #include "Core.hpp"
+#include "WorldStreamer.hpp"
 #include "Handles/SceneHandle.hpp"
 
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Rigel
 {
@@ -41,10 +46,61 @@ namespace Rigel
          */
         NODISCARD SceneHandle GetSceneByID(const uid_t id) const;
 
-        NODISCARD bool IsSceneLoaded() const { return !m_LoadedScene.IsNull(); }
+        NODISCARD bool IsSceneLoaded() const { return !m_LoadedScenes.empty(); }
+
+        // Returns the first of the loaded scenes, which is the one loaded by LoadScene unless it was unloaded
         NODISCARD SceneHandle GetLoadedScene() const;
 
+        // All loaded scenes in the order they were loaded, the span is invalidated by loading and unloading scenes
+        NODISCARD std::span<const SceneHandle> GetLoadedScenes() const { return m_LoadedScenes; }
+
+        // Unloads all loaded scenes, including streamed world cells, and loads the scene
         void LoadScene(SceneHandle& scene);
+
+        /**
+         * Loads the scene over multiple frames, all loaded scenes are unloaded immediately.
+         * Every frame objects run their OnLoad and then their OnStart until the frame budget is used up,
+         * OnStart of any object still only runs after OnLoad ran for all of them.
+         * The scene counts as loaded right away, objects instantiated meanwhile join the load.
+         * @param scene The scene to load
+         * @param frameBudget Time in milliseconds spent on loading per frame, at least one object is processed per frame.
+         * Also used by later additive incremental loads
+         */
+        void LoadSceneIncremental(SceneHandle& scene, const float64_t frameBudget = 4.0);
+
+        /**
+         * Loads the scene next to the scenes that are already loaded. Scenes are independent,
+         * objects on one scene can't be parented to objects on another one.
+         * @param scene The scene to load
+         * @param incremental If true, the scene is loaded over multiple frames like with LoadSceneIncremental.
+         * Scenes being loaded incrementally share a single frame budget
+         */
+        void LoadSceneAdditive(SceneHandle& scene, const bool incremental = false);
+
+        // Unloads a single loaded scene, the other loaded scenes stay loaded
+        void UnloadScene(const SceneHandle& scene);
+
+        NODISCARD bool IsLoadingScene() const;
+
+        // Progress of the least loaded scene from 0 to 1, 1 if no scene is being loaded incrementally
+        NODISCARD float32_t GetLoadProgress() const;
+
+        /**
+         * Starts streaming world cells in and out around the first camera of the loaded scenes, see WorldStreamingSettings.
+         * Cells are loaded additively, they are read and deserialized on the asset loading threads.
+         * Cells that were already streamed with different settings are unloaded.
+         */
+        void EnableWorldStreaming(const WorldStreamingSettings& settings) { m_WorldStreamer.Enable(settings); }
+
+        // Stops streaming and unloads all world cells
+        void DisableWorldStreaming() { m_WorldStreamer.Disable(); }
+
+        NODISCARD bool IsWorldStreamingEnabled() const { return m_WorldStreamer.IsEnabled(); }
+
+        // Streams cells around the given position instead of the camera, pass std::nullopt to follow the camera again
+        void SetStreamingFocus(const std::optional<glm::vec3>& focus) { m_WorldStreamer.SetFocus(focus); }
+
+        NODISCARD size_t GetLoadedCellCount() const { return m_WorldStreamer.GetLoadedCellCount(); }
     INTERNAL:
         SceneManager();
         ~SceneManager() override;
@@ -52,12 +108,28 @@ namespace Rigel
         ErrorCode Startup(const ProjectSettings& settings) override;
         ErrorCode Shutdown() override;
 
-        void UnloadCurrentScene();
+        void UnloadCurrentScene(); // Unloads all loaded scenes
+
+        /**
+         * Creates a scene that is not registered yet, so it can be filled on another thread.
+         * Thread safe. The scene must be adopted before it's loaded.
+         */
+        NODISCARD std::unique_ptr<Scene> CreateDetachedScene(std::string name = "New Scene");
+        SceneHandle AdoptScene(std::unique_ptr<Scene> scene);
+
+        // Destroys the objects of a scene that was never adopted and then the scene itself. Thread safe.
+        void DestroyDetachedScene(std::unique_ptr<Scene> scene);
+
+        void Update(); // Continues incremental loading, called once per frame before the game update
+        void OnEndOfFrame(); // Integrates streamed world cells
     private:
         NODISCARD uid_t GetNextSceneID() { return m_NextSceneID++; }
 
-        uid_t m_NextSceneID = 1;
+        std::atomic<uid_t> m_NextSceneID = 1;
         std::unordered_map<uid_t, std::unique_ptr<Scene>> m_Scenes;
-        SceneHandle m_LoadedScene;
+        std::vector<SceneHandle> m_LoadedScenes;
+        float64_t m_LoadFrameBudget = 4.0;
+
+        Backend::WorldStreamer m_WorldStreamer;
     };
 }
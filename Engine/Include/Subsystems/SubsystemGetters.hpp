@@ -13,6 +13,7 @@ namespace Rigel
     class WindowManager;
     class InputManager;
     class PhysicsEngine;
+    class SystemScheduler;
 
     NODISCARD Ref<Engine> GetEngine();
     NODISCARD Ref<Time> GetTime();
@@ -23,4 +24,5 @@ namespace Rigel
     NODISCARD Ref<WindowManager> GetWindowManager();
     NODISCARD Ref<InputManager> GetInputManager();
     NODISCARD Ref<PhysicsEngine> GetPhysicsEngine();
+    NODISCARD Ref<SystemScheduler> GetSystemScheduler();
 }
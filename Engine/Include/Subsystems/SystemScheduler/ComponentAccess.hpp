@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ECS/Component.hpp"
+#include "ECS/ComponentStorage.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace Rigel
+{
+    /**
+     * Describes which component types a system reads and writes.
+     *
+     * Two systems may run in parallel only if neither of them writes a component type the other one accesses.
+     * Writing a component type implies reading it.
+     */
+    class ComponentAccess
+    {
+    public:
+        template<typename... T>
+        ComponentAccess& Read()
+        {
+            static_assert((std::is_base_of_v<Component, T> && ...), "T must derive from Rigel::Component");
+            (SetBit(m_ReadMask, ComponentTypeID::Get<T>()), ...);
+            return *this;
+        }
+
+        template<typename... T>
+        ComponentAccess& Write()
+        {
+            static_assert((std::is_base_of_v<Component, T> && ...), "T must derive from Rigel::Component");
+            (SetBit(m_WriteMask, ComponentTypeID::Get<T>()), ...);
+            return *this;
+        }
+
+        /**
+         * Marks the system as touching state that can't be described by component types (scenes, subsystems, etc.).
+         * Exclusive systems never run in parallel with other systems and always run on the main thread.
+         */
+        ComponentAccess& Exclusive()
+        {
+            m_Exclusive = true;
+            return *this;
+        }
+
+        NODISCARD bool IsExclusive() const { return m_Exclusive; }
+
+        NODISCARD bool ConflictsWith(const ComponentAccess& other) const
+        {
+            if (m_Exclusive || other.m_Exclusive)
+                return true;
+
+            return Intersects(m_WriteMask, other.m_WriteMask) ||
+                   Intersects(m_WriteMask, other.m_ReadMask) ||
+                   Intersects(m_ReadMask, other.m_WriteMask);
+        }
+    private:
+        static void SetBit(std::vector<uint64_t>& mask, const type_id_t typeID)
+        {
+            const auto word = typeID / 64;
+            if (word >= mask.size())
+                mask.resize(word + 1, 0);
+
+            mask[word] |= 1ull << (typeID % 64);
+        }
+
+        NODISCARD static bool Intersects(const std::vector<uint64_t>& lhs, const std::vector<uint64_t>& rhs)
+        {
+            const auto words = std::min(lhs.size(), rhs.size());
+            for (size_t i = 0; i < words; ++i)
+            {
+                if (lhs[i] & rhs[i])
+                    return true;
+            }
+
+            return false;
+        }
+
+        std::vector<uint64_t> m_ReadMask;
+        std::vector<uint64_t> m_WriteMask;
+        bool m_Exclusive = false;
+    };
+}
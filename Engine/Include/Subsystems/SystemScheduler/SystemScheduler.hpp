@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Core.hpp"
+#include "ComponentAccess.hpp"
+#include "Subsystems/RigelSubsystem.hpp"
+#include "Subsystems/EventSystem/EngineEvents.hpp"
+#include "Utilities/Threading/JobSystem.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Rigel
+{
+    class ProjectSettings;
+
+    /**
+     * Runs gameplay systems in parallel every frame.
+     *
+     * Every system declares which component types it reads and writes. Systems that conflict with each other
+     * run in the order they were added, all other systems run on the scheduler's thread pool at the same time.
+     * Systems run after GameUpdateEvent has been dispatched and before transforms are updated.
+     *
+     * Scenes are not thread-safe, systems must use SceneCommandBuffer to instantiate or destroy objects
+     * and to add or remove components.
+     */
+    class SystemScheduler final : public RigelSubsystem
+    {
+    public:
+        using SystemID = uid_t;
+        using SystemFunction = std::function<void(const GameUpdateEvent&)>;
+
+        ErrorCode Startup(const ProjectSettings& settings) override;
+        ErrorCode Shutdown() override;
+
+        /**
+         * Registers a system that is executed once per frame. Must not be called from inside a system.
+         * @param name Name of the system, used for debugging only
+         * @param access Component types the system reads and writes
+         * @param function The system itself, exceptions it throws are logged and count as the system finishing
+         * @return ID of the system, required to remove it
+         */
+        SystemID AddSystem(std::string name, ComponentAccess access, SystemFunction function);
+        void RemoveSystem(const SystemID id);
+
+        NODISCARD size_t GetSystemCount() const { return m_Systems.size(); }
+        NODISCARD size_t GetThreadCount() const { return m_JobSystem ? m_JobSystem->GetSize() : 0; }
+    INTERNAL:
+        // Runs all systems and blocks until they are finished, called by Engine once per frame
+        void Update(const GameUpdateEvent& event);
+
+        // The job system is idle outside of Update, other engine code may use it for parallel work
+        NODISCARD JobSystem* GetJobSystem() const { return m_JobSystem.get(); }
+    private:
+        struct System
+        {
+            SystemID ID;
+            std::string Name;
+            ComponentAccess Access;
+            SystemFunction Function;
+        };
+
+        // Systems that must wait for this one to finish and the number of systems this one waits for
+        struct GraphNode
+        {
+            std::vector<uint32_t> Dependents;
+            uint32_t DependencyCount = 0;
+        };
+
+        void RebuildGraph();
+
+        void Schedule(const uint32_t index, const GameUpdateEvent& event);
+        void RunSystem(const uint32_t index, const GameUpdateEvent& event);
+
+        std::vector<System> m_Systems;
+        std::vector<GraphNode> m_Graph;
+        bool m_GraphDirty = false;
+        SystemID m_NextSystemID = 1;
+
+        std::unique_ptr<JobSystem> m_JobSystem;
+
+        // State of the current Update call
+        std::unique_ptr<std::atomic<uint32_t>[]> m_PendingDependencies;
+        std::vector<uint32_t> m_MainThreadQueue;
+        size_t m_CompletedCount = 0;
+        std::mutex m_RunMutex;
+        std::condition_variable m_RunCondition;
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Math.hpp"
+#include "Handles/SceneHandle.hpp"
+#include "Handles/AssetHandle.hpp"
+#include "Assets/SceneAsset.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <unordered_map>
+
+namespace Rigel
+{
+    /**
+     * Describes a world split into square cells on the XZ plane, each cell being a separate scene file.
+     * Cell (x, z) covers positions from (x, z) * CellSize to (x + 1, z + 1) * CellSize and is loaded from
+     * "<CellsDirectory>/Cell_<x>_<z>.json". Cells without a file are treated as empty.
+     */
+    struct WorldStreamingSettings
+    {
+        std::filesystem::path CellsDirectory;
+        float32_t CellSize = 100.0f;
+
+        // Cells at most this many cells away from the focus cell are loaded, distance is max(|dx|, |dz|)
+        int32_t LoadRadius = 1;
+
+        // Cells further away than this are unloaded, keeping it above LoadRadius stops cells on the border
+        // from being loaded and unloaded over and over when the focus moves back and forth
+        int32_t UnloadRadius = 2;
+
+        // Limits the number of cells that are loaded or being loaded at once, which bounds memory use.
+        // When the limit is reached, loaded cells outside LoadRadius are evicted for nearer ones
+        size_t MaxCells = 25;
+    };
+}
+
+namespace Rigel::Backend
+{
+    /**
+     * Streams cell scenes in and out around a focus point, owned by SceneManager.
+     *
+     * Cells are loaded with AssetManager::LoadAsync, so reading and deserializing a cell happens on a loading thread.
+     * Cells that finished loading are added to the loaded scenes at the end of the frame and activated
+     * incrementally within the scene load budget, see SceneManager::LoadSceneAdditive.
+     */
+    class WorldStreamer
+    {
+    public:
+        WorldStreamer() = default;
+        ~WorldStreamer() = default;
+
+        WorldStreamer(const WorldStreamer&) = delete;
+        WorldStreamer& operator = (const WorldStreamer&) = delete;
+
+        void Enable(const WorldStreamingSettings& settings);
+        void Disable(); // Unloads all cells
+
+        NODISCARD bool IsEnabled() const { return m_Enabled; }
+        NODISCARD const WorldStreamingSettings& GetSettings() const { return m_Settings; }
+
+        // Overrides the focus, by default cells are streamed around the first camera of the loaded scenes
+        void SetFocus(const std::optional<glm::vec3>& focus) { m_Focus = focus; }
+
+        NODISCARD size_t GetLoadedCellCount() const;
+        NODISCARD size_t GetPendingCellCount() const;
+
+        // Integrates finished cells, unloads far cells and requests new ones. Called at the end of every frame
+        void Update();
+
+        // Unloads all cells but keeps streaming, cells around the focus are loaded again during the next update
+        void UnloadAllCells();
+    private:
+        enum class CellState : uint8_t
+        {
+            Loading,
+            Loaded,
+            Empty // The cell has no file or its file failed to load, nothing is retried until the cell is forgotten
+        };
+
+        struct Cell
+        {
+            glm::ivec2 Coords;
+            CellState State = CellState::Empty;
+            AssetHandle<SceneAsset> Asset; // Only set while loading
+            SceneHandle Scene; // Only set once loaded
+        };
+
+        NODISCARD static uint64_t GetCellKey(const glm::ivec2& coords)
+        {
+            return static_cast<uint64_t>(static_cast<uint32_t>(coords.x)) << 32 | static_cast<uint32_t>(coords.y);
+        }
+
+        NODISCARD static int32_t GetCellDistance(const glm::ivec2& a, const glm::ivec2& b)
+        {
+            return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+        }
+
+        NODISCARD std::optional<glm::vec3> FindFocus() const;
+        NODISCARD std::filesystem::path GetCellPath(const glm::ivec2& coords) const;
+
+        // Returns false if the cell got a stale asset and has to be requested again
+        NODISCARD bool IntegrateCell(Cell& cell);
+        static void UnloadCell(Cell& cell);
+
+        // Unloads the loading or loaded cell furthest from the center that is outside LoadRadius, returns false if there is none
+        bool EvictFarthestCell(const glm::ivec2& center);
+
+        WorldStreamingSettings m_Settings;
+        std::optional<glm::vec3> m_Focus;
+        bool m_Enabled = false;
+
+        std::unordered_map<uint64_t, Cell> m_Cells;
+        size_t m_ActiveCellCount = 0; // Cells that are loading or loaded, bounded by MaxCells
+    };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Rigel
+{
+    template<typename Signature>
+    class Delegate;
+
+    /**
+     * A non-allocating replacement of std::function for callbacks that are invoked often.
+     *
+     * A delegate is a function pointer (the thunk) that restores the type of the bound callable, an instance pointer
+     * and a few bytes of inline storage. The storage fits a pointer to a member function or a lambda capturing
+     * up to two pointers, bigger callables and callables that are not trivially copyable are rejected at compile time.
+     * Delegates never own the bound instance, it must outlive the delegate.
+     */
+    template<typename R, typename... Args>
+    class Delegate<R(Args...)>
+    {
+    public:
+        static constexpr size_t STORAGE_SIZE = 2 * sizeof(void*);
+
+        struct Storage
+        {
+            alignas(void*) std::byte Bytes[STORAGE_SIZE];
+
+            template<typename T>
+            NODISCARD const T& As() const { return *std::launder(reinterpret_cast<const T*>(Bytes)); }
+        };
+
+        using Thunk = R(*)(void* instance, const Storage& storage, Args... args);
+
+        Delegate() = default;
+
+        // Binds a free function
+        NODISCARD static Delegate FromFunction(R (*function)(Args...))
+        {
+            return Bind(function, nullptr, [](void*, const Storage& storage, Args... args) -> R
+            {
+                return storage.template As<R (*)(Args...)>()(std::forward<Args>(args)...);
+            });
+        }
+
+        // Binds a method of the instance
+        template<typename T>
+        NODISCARD static Delegate FromMethod(T* instance, R (T::*method)(Args...))
+        {
+            return Bind(method, instance, [](void* object, const Storage& storage, Args... args) -> R
+            {
+                return (static_cast<T*>(object)->*storage.template As<R (T::*)(Args...)>())(std::forward<Args>(args)...);
+            });
+        }
+
+        // Binds a callable object such as a lambda, the object is copied into the delegate
+        template<typename F> requires std::is_invocable_r_v<R, const F&, Args...>
+        NODISCARD static Delegate FromCallable(const F& callable)
+        {
+            return Bind(callable, nullptr, [](void*, const Storage& storage, Args... args) -> R
+            {
+                return storage.template As<F>()(std::forward<Args>(args)...);
+            });
+        }
+
+        /**
+         * Creates a delegate from a custom thunk, use it when the callable needs additional logic around the call.
+         * The thunk gets the instance and a copy of data back, data is read through Storage::As<Data>.
+         */
+        template<typename Data>
+        NODISCARD static Delegate Bind(const Data& data, void* instance, const Thunk thunk)
+        {
+            static_assert(sizeof(Data) <= STORAGE_SIZE && alignof(Data) <= alignof(void*),
+                "The callable is too big to be stored in a delegate, capture a pointer to its state instead");
+            static_assert(std::is_trivially_copyable_v<Data> && std::is_trivially_destructible_v<Data>,
+                "Only trivially copyable callables can be stored in a delegate");
+
+            auto delegate = Delegate();
+            delegate.m_Thunk = thunk;
+            delegate.m_Instance = instance;
+            new (delegate.m_Storage.Bytes) Data(data);
+
+            return delegate;
+        }
+
+        R operator () (Args... args) const
+        {
+            return m_Thunk(m_Instance, m_Storage, std::forward<Args>(args)...);
+        }
+
+        NODISCARD explicit operator bool () const { return m_Thunk != nullptr; }
+
+        NODISCARD Thunk GetThunk() const { return m_Thunk; }
+        NODISCARD void* GetInstance() const { return m_Instance; }
+        NODISCARD const Storage& GetStorage() const { return m_Storage; }
+    private:
+        Thunk m_Thunk = nullptr;
+        void* m_Instance = nullptr;
+        Storage m_Storage{};
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <filesystem>
+#include <span>
+
+namespace Rigel
+{
+    /**
+     * Read-only view of a whole file mapped into memory. Pages are read by the OS on first access,
+     * so opening a file is cheap regardless of its size and data can be used in place instead of being copied.
+     * The mapping is released when the object is destroyed, spans returned by GetData must not outlive it.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator = (MappedFile&& other) noexcept;
+
+        // Empty files are opened successfully, the returned file has no data
+        NODISCARD static Result<MappedFile> Open(const std::filesystem::path& path);
+
+        NODISCARD std::span<const byte_t> GetData() const { return {m_Data, m_Size}; }
+        NODISCARD size_t GetSize() const { return m_Size; }
+    private:
+        MappedFile(const byte_t* data, const size_t size) : m_Data(data), m_Size(size) { }
+
+        void Close();
+
+        const byte_t* m_Data = nullptr;
+        size_t m_Size = 0;
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Rigel
+{
+    /**
+     * Axis aligned bounding box. A default constructed box is empty, merging anything into it yields that thing.
+     */
+    struct AABB
+    {
+        glm::vec3 Min = glm::vec3(std::numeric_limits<float32_t>::max());
+        glm::vec3 Max = glm::vec3(std::numeric_limits<float32_t>::lowest());
+
+        AABB() = default;
+        AABB(const glm::vec3& min, const glm::vec3& max) : Min(min), Max(max) { }
+
+        NODISCARD static AABB FromPoint(const glm::vec3& point) { return {point, point}; }
+
+        NODISCARD bool IsEmpty() const { return Min.x > Max.x || Min.y > Max.y || Min.z > Max.z; }
+
+        NODISCARD glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+        NODISCARD glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+        // Half of the surface area, the tree only compares areas so the factor of 2 is dropped
+        NODISCARD float32_t GetHalfArea() const
+        {
+            const auto size = Max - Min;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+        void Merge(const glm::vec3& point)
+        {
+            Min = glm::min(Min, point);
+            Max = glm::max(Max, point);
+        }
+
+        void Merge(const AABB& other)
+        {
+            Min = glm::min(Min, other.Min);
+            Max = glm::max(Max, other.Max);
+        }
+
+        NODISCARD static AABB Merge(const AABB& lhs, const AABB& rhs)
+        {
+            return {glm::min(lhs.Min, rhs.Min), glm::max(lhs.Max, rhs.Max)};
+        }
+
+        NODISCARD AABB Expanded(const float32_t margin) const { return {Min - glm::vec3(margin), Max + glm::vec3(margin)}; }
+
+        NODISCARD bool Overlaps(const AABB& other) const
+        {
+            return Min.x <= other.Max.x && Max.x >= other.Min.x &&
+                   Min.y <= other.Max.y && Max.y >= other.Min.y &&
+                   Min.z <= other.Max.z && Max.z >= other.Min.z;
+        }
+
+        NODISCARD bool Contains(const AABB& other) const
+        {
+            return Min.x <= other.Min.x && Max.x >= other.Max.x &&
+                   Min.y <= other.Min.y && Max.y >= other.Max.y &&
+                   Min.z <= other.Min.z && Max.z >= other.Max.z;
+        }
+
+        // Squared distance from the point to the closest point of the box, 0 if the point is inside
+        NODISCARD float32_t DistanceSquared(const glm::vec3& point) const
+        {
+            const auto closest = glm::clamp(point, Min, Max);
+            const auto delta = point - closest;
+            return glm::dot(delta, delta);
+        }
+
+        // Bounds of this box after transformation, computed from the transformed center and extents
+        NODISCARD AABB Transformed(const glm::mat4& matrix) const
+        {
+            const auto center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.0f));
+            const auto extents = GetExtents();
+
+            const auto newExtents = glm::vec3(
+                std::abs(matrix[0][0]) * extents.x + std::abs(matrix[1][0]) * extents.y + std::abs(matrix[2][0]) * extents.z,
+                std::abs(matrix[0][1]) * extents.x + std::abs(matrix[1][1]) * extents.y + std::abs(matrix[2][1]) * extents.z,
+                std::abs(matrix[0][2]) * extents.x + std::abs(matrix[1][2]) * extents.y + std::abs(matrix[2][2]) * extents.z);
+
+            return {center - newExtents, center + newExtents};
+        }
+    };
+
+    struct Ray
+    {
+        glm::vec3 Origin;
+        glm::vec3 Direction; // Must be normalized
+
+        /**
+         * Slab test against the box.
+         * @param inverseDirection 1 / Direction, precomputed since rays are usually tested against many boxes
+         * @param maxDistance Hits further than this are ignored
+         * @param distance Receives the distance to the entry point, 0 if the origin is inside the box
+         */
+        NODISCARD bool Intersects(const AABB& box, const glm::vec3& inverseDirection, const float32_t maxDistance, float32_t& distance) const
+        {
+            const auto t0 = (box.Min - Origin) * inverseDirection;
+            const auto t1 = (box.Max - Origin) * inverseDirection;
+
+            const auto tMin = glm::min(t0, t1);
+            const auto tMax = glm::max(t0, t1);
+
+            const auto enter = std::max({tMin.x, tMin.y, tMin.z, 0.0f});
+            const auto exit = std::min({tMax.x, tMax.y, tMax.z, maxDistance});
+
+            distance = enter;
+            return enter <= exit;
+        }
+    };
+
+    /**
+     * Six planes of a view frustum, normals point inside. Planes are stored as (normal, distance),
+     * a point p is on the inner side of a plane if dot(normal, p) + distance >= 0.
+     */
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> Planes;
+
+        /**
+         * Extracts the planes from a projection * view matrix.
+         * The near plane is extracted for a [-1, 1] depth range, which is slightly looser than
+         * the [0, 1] range used by the renderer, so culling stays conservative with both conventions.
+         */
+        NODISCARD static Frustum FromMatrix(const glm::mat4& projView)
+        {
+            const auto row = [&projView](const glm::length_t i)
+            {
+                return glm::vec4(projView[0][i], projView[1][i], projView[2][i], projView[3][i]);
+            };
+
+            auto frustum = Frustum();
+            frustum.Planes = {
+                row(3) + row(0), row(3) - row(0), // Left, right
+                row(3) + row(1), row(3) - row(1), // Bottom, top (swapped when the projection flips Y)
+                row(3) + row(2), row(3) - row(2)  // Near, far
+            };
+
+            for (auto& plane : frustum.Planes)
+                plane /= glm::length(glm::vec3(plane));
+
+            return frustum;
+        }
+
+        // Conservative test, may report boxes near the frustum corners as intersecting
+        NODISCARD bool Intersects(const AABB& box) const
+        {
+            const auto center = box.GetCenter();
+            const auto extents = box.GetExtents();
+
+            for (const auto& plane : Planes)
+            {
+                const auto normal = glm::vec3(plane);
+                const auto radius = glm::dot(extents, glm::abs(normal));
+
+                if (glm::dot(normal, center) + plane.w < -radius)
+                    return false;
+            }
+
+            return true;
+        }
+    };
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <bit>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Rigel
+{
+    /**
+     * Keeps objects of type T in fixed-size chunks of contiguous memory and recycles the slots of destroyed objects.
+     *
+     * Objects never move once created, so raw pointers to them stay valid until they are destroyed.
+     * Every object is identified by a slot index, which the owner must keep to be able to destroy it.
+     * Iterating the pool is a linear scan over the chunks, skipping empty slots with bit scans.
+     *
+     * Every slot also carries an active bit, objects are active when created. Iterating from ActiveBegin
+     * visits active objects only, skipping inactive ones with the same bit scans.
+     *
+     * T's constructor and destructor are invoked by the pool, so classes that hide them must befriend ObjectPool<T>.
+     */
+    template<typename T>
+    class ObjectPool
+    {
+        struct Chunk;
+    public:
+        static constexpr uint32_t CHUNK_CAPACITY = 64; // Must match the width of Chunk::OccupiedMask
+
+        class Iterator
+        {
+        public:
+            Iterator(const ObjectPool* pool, const size_t chunkIndex, const uint32_t slotIndex)
+                : m_Pool(pool), m_ChunkIndex(chunkIndex), m_SlotIndex(slotIndex) { }
+
+            Iterator(const ObjectPool* pool, const size_t chunkIndex, const uint32_t slotIndex, uint64_t Chunk::* mask)
+                : m_Pool(pool), m_ChunkIndex(chunkIndex), m_SlotIndex(slotIndex), m_Mask(mask) { }
+
+            T& operator * () const { return *m_Pool->m_Chunks[m_ChunkIndex]->Get(m_SlotIndex); }
+            T* operator -> () const { return m_Pool->m_Chunks[m_ChunkIndex]->Get(m_SlotIndex); }
+
+            Iterator& operator ++ ()
+            {
+                // Re-reading the mask allows objects to be destroyed while the pool is being iterated
+                const auto& chunks = m_Pool->m_Chunks;
+                auto mask = (*chunks[m_ChunkIndex]).*m_Mask & ~((2ull << m_SlotIndex) - 1);
+
+                while (mask == 0)
+                {
+                    if (++m_ChunkIndex >= chunks.size())
+                    {
+                        m_SlotIndex = 0;
+                        return *this;
+                    }
+
+                    mask = (*chunks[m_ChunkIndex]).*m_Mask;
+                }
+
+                m_SlotIndex = std::countr_zero(mask);
+                return *this;
+            }
+
+            bool operator == (const Iterator& other) const
+            {
+                return m_ChunkIndex == other.m_ChunkIndex && m_SlotIndex == other.m_SlotIndex;
+            }
+        private:
+            const ObjectPool* m_Pool;
+            size_t m_ChunkIndex;
+            uint32_t m_SlotIndex;
+            uint64_t Chunk::* m_Mask = &Chunk::OccupiedMask; // Selects between all objects and active objects only
+        };
+
+        ObjectPool() = default;
+        ~ObjectPool()
+        {
+            for (const auto& chunk : m_Chunks)
+            {
+                for (auto mask = chunk->OccupiedMask; mask != 0; mask &= mask - 1)
+                    chunk->Get(std::countr_zero(mask))->~T();
+            }
+        }
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator = (const ObjectPool&) = delete;
+
+        /**
+         * Constructs a new object inside the pool.
+         * @param slot Receives the slot index of the new object, required to destroy it later
+         * @param args Constructor arguments
+         * @return A pointer to the new object
+         */
+        template<typename... Args>
+        NODISCARD T* Emplace(uint32_t& slot, Args&&... args)
+        {
+            if (m_FreeSlots.empty())
+                AllocateChunk();
+
+            const auto freeSlot = m_FreeSlots.back();
+            const auto& chunk = m_Chunks[freeSlot / CHUNK_CAPACITY];
+            const auto slotIndex = freeSlot % CHUNK_CAPACITY;
+
+            const auto object = new (chunk->Get(slotIndex)) T(std::forward<Args>(args)...);
+
+            // Only mark the slot as taken once the constructor succeeded
+            m_FreeSlots.pop_back();
+            chunk->OccupiedMask |= 1ull << slotIndex;
+            chunk->ActiveMask |= 1ull << slotIndex;
+            ++m_Size;
+
+            slot = freeSlot;
+            return object;
+        }
+
+        // Destroys the object occupying the given slot, the slot will be reused by subsequent Emplace calls
+        void Erase(const uint32_t slot)
+        {
+            const auto& chunk = m_Chunks[slot / CHUNK_CAPACITY];
+            const auto slotIndex = slot % CHUNK_CAPACITY;
+
+            ASSERT(chunk->OccupiedMask & (1ull << slotIndex), "Attempted to erase an empty object pool slot");
+
+            chunk->Get(slotIndex)->~T();
+
+            chunk->OccupiedMask &= ~(1ull << slotIndex);
+            chunk->ActiveMask &= ~(1ull << slotIndex);
+            m_FreeSlots.push_back(slot);
+            --m_Size;
+        }
+
+        // Allocates chunks until count more objects can be created without allocating,
+        // new chunks are used first, so objects created right after this call are stored next to each other
+        void Reserve(const size_t count)
+        {
+            while (m_FreeSlots.size() < count)
+                AllocateChunk();
+        }
+
+        NODISCARD T* Get(const uint32_t slot) const
+        {
+            return m_Chunks[slot / CHUNK_CAPACITY]->Get(slot % CHUNK_CAPACITY);
+        }
+
+        // The active bit has no meaning to the pool itself, owners use it to filter iteration
+        void SetActive(const uint32_t slot, const bool active)
+        {
+            const auto& chunk = m_Chunks[slot / CHUNK_CAPACITY];
+            const auto bit = 1ull << (slot % CHUNK_CAPACITY);
+
+            ASSERT(chunk->OccupiedMask & bit, "Attempted to activate an empty object pool slot");
+            chunk->ActiveMask = active ? chunk->ActiveMask | bit : chunk->ActiveMask & ~bit;
+        }
+
+        NODISCARD bool IsActive(const uint32_t slot) const
+        {
+            return m_Chunks[slot / CHUNK_CAPACITY]->ActiveMask & (1ull << (slot % CHUNK_CAPACITY));
+        }
+
+        NODISCARD size_t GetSize() const { return m_Size; }
+        NODISCARD bool IsEmpty() const { return m_Size == 0; }
+
+        NODISCARD Iterator begin() const
+        {
+            for (size_t i = 0; i < m_Chunks.size(); ++i)
+            {
+                if (const auto mask = m_Chunks[i]->OccupiedMask; mask != 0)
+                    return {this, i, static_cast<uint32_t>(std::countr_zero(mask))};
+            }
+
+            return end();
+        }
+
+        // Iterates active objects only, use end() as the end of the range
+        NODISCARD Iterator ActiveBegin() const
+        {
+            for (size_t i = 0; i < m_Chunks.size(); ++i)
+            {
+                if (const auto mask = m_Chunks[i]->ActiveMask; mask != 0)
+                    return {this, i, static_cast<uint32_t>(std::countr_zero(mask)), &Chunk::ActiveMask};
+            }
+
+            return end();
+        }
+
+        NODISCARD Iterator end() const { return {this, m_Chunks.size(), 0}; }
+    private:
+        struct Chunk
+        {
+            alignas(T) std::byte Data[sizeof(T) * CHUNK_CAPACITY];
+            uint64_t OccupiedMask = 0;
+            uint64_t ActiveMask = 0; // Always a subset of OccupiedMask
+
+            NODISCARD T* Get(const uint32_t index) { return std::launder(reinterpret_cast<T*>(Data + sizeof(T) * index)); }
+        };
+
+        void AllocateChunk()
+        {
+            const auto firstSlot = static_cast<uint32_t>(m_Chunks.size() * CHUNK_CAPACITY);
+            m_Chunks.push_back(std::make_unique<Chunk>());
+
+            // Pushed in reverse so that the lowest slots are handed out first, keeping live objects packed
+            for (uint32_t i = CHUNK_CAPACITY; i > 0; --i)
+                m_FreeSlots.push_back(firstSlot + i - 1);
+        }
+
+        std::vector<std::unique_ptr<Chunk>> m_Chunks;
+        std::vector<uint32_t> m_FreeSlots;
+        size_t m_Size = 0;
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <atomic>
+
+namespace Rigel
+{
+    typedef uint32_t type_id_t;
+
+    /**
+     * Assigns small dense integer IDs to types, starting from zero.
+     *
+     * IDs are counted separately for every Family, e.g. TypeID<Component> and TypeID<Event> both start at zero,
+     * which allows them to be used as indices into flat arrays instead of hashing std::type_index.
+     * An ID is assigned the first time Get<T> is called for a type and stays the same for the whole run,
+     * it is NOT stable between runs and must never be serialized.
+     * @tparam Family Tag type that defines the ID space
+     */
+    template<typename Family>
+    class TypeID
+    {
+    public:
+        template<typename T>
+        NODISCARD static type_id_t Get()
+        {
+            static const auto id = s_NextID.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+
+        // Returns how many types were assigned an ID in this family so far
+        NODISCARD static type_id_t GetCount() { return s_NextID.load(std::memory_order_relaxed); }
+    private:
+        inline static std::atomic<type_id_t> s_NextID = 0;
+    };
+}
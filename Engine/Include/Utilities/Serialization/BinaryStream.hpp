@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Rigel
+{
+    template<typename T>
+    concept BinaryValueConcept = std::is_trivially_copyable_v<T>;
+
+    /**
+     * Appends raw values to a growing byte buffer. Values are written in native byte order and without padding,
+     * the data can only be read back by a BinaryReader on a platform with the same endianness.
+     */
+    class BinaryWriter
+    {
+    public:
+        template<BinaryValueConcept T>
+        void Write(const T& value) { WriteBytes(&value, sizeof(T)); }
+
+        template<BinaryValueConcept T>
+        void WriteArray(std::span<const T> values) { WriteBytes(values.data(), values.size_bytes()); }
+
+        // Strings are prefixed with their size
+        void WriteString(const std::string_view string)
+        {
+            Write(static_cast<uint32_t>(string.size()));
+            WriteBytes(string.data(), string.size());
+        }
+
+        void WriteBytes(const void* data, const size_t size)
+        {
+            const auto bytes = static_cast<const byte_t*>(data);
+            m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+        }
+
+        // Replaces a value written earlier, used for sizes and counts that are only known once the data after them is written
+        template<BinaryValueConcept T>
+        void Overwrite(const size_t offset, const T& value)
+        {
+            ASSERT(offset + sizeof(T) <= m_Buffer.size(), "Overwritten value is out of the binary writer range");
+            std::memcpy(m_Buffer.data() + offset, &value, sizeof(T));
+        }
+
+        void Reserve(const size_t size) { m_Buffer.reserve(size); }
+
+        NODISCARD size_t GetSize() const { return m_Buffer.size(); }
+        NODISCARD std::span<const byte_t> GetData() const { return m_Buffer; }
+
+        NODISCARD std::vector<byte_t> TakeBuffer() { return std::move(m_Buffer); }
+    private:
+        std::vector<byte_t> m_Buffer;
+    };
+
+    /**
+     * Reads values written by BinaryWriter from a range of bytes, e.g. a MappedFile. Data may be unaligned.
+     *
+     * Every read is bounds checked. A read past the end fails and puts the reader into the failed state,
+     * in which all following reads fail as well, so a sequence of reads can be validated once with IsOK.
+     */
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(const std::span<const byte_t> data) : m_Data(data) { }
+
+        template<BinaryValueConcept T>
+        bool Read(T& value) { return ReadBytes(&value, sizeof(T)); }
+
+        // Copies count values with a single memcpy
+        template<BinaryValueConcept T>
+        bool ReadArray(std::vector<T>& values, const size_t count)
+        {
+            if (!CanRead(count, sizeof(T)))
+                return Fail();
+
+            values.resize(count);
+            return ReadBytes(values.data(), count * sizeof(T));
+        }
+
+        bool ReadString(std::string& string)
+        {
+            uint32_t size = 0;
+            if (!Read(size) || !CanRead(size, 1))
+                return Fail();
+
+            string.assign(m_Data.data() + m_Position, size);
+            m_Position += size;
+
+            return true;
+        }
+
+        // Returns the next size bytes without copying them, or an empty span if there are not enough bytes left
+        NODISCARD std::span<const byte_t> ReadSpan(const size_t size)
+        {
+            if (!CanRead(size, 1))
+            {
+                Fail();
+                return {};
+            }
+
+            const auto span = m_Data.subspan(m_Position, size);
+            m_Position += size;
+
+            return span;
+        }
+
+        bool ReadBytes(void* destination, const size_t size)
+        {
+            if (!CanRead(size, 1))
+                return Fail();
+
+            if (size > 0)
+                std::memcpy(destination, m_Data.data() + m_Position, size);
+            m_Position += size;
+
+            return true;
+        }
+
+        NODISCARD bool IsOK() const { return !m_Failed; }
+        NODISCARD bool IsAtEnd() const { return m_Position == m_Data.size(); }
+        NODISCARD size_t GetPosition() const { return m_Position; }
+    private:
+        // Written to not overflow for corrupted counts
+        NODISCARD bool CanRead(const size_t count, const size_t size) const
+        {
+            return !m_Failed && count <= (m_Data.size() - m_Position) / size;
+        }
+
+        bool Fail()
+        {
+            m_Failed = true;
+            return false;
+        }
+
+        std::span<const byte_t> m_Data;
+        size_t m_Position = 0;
+        bool m_Failed = false;
+    };
+}
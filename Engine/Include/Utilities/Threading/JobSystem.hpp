@@ -0,0 +1,220 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Rigel
+{
+    class JobSystem;
+
+    namespace Backend
+    {
+        struct JobLink;
+
+        /**
+         * A unit of work. Callables small enough are stored inside the job itself, bigger ones on the heap.
+         * Jobs are recycled through per-thread caches, scheduling a job normally doesn't allocate.
+         */
+        struct alignas(64) Job
+        {
+            static constexpr size_t STORAGE_SIZE = 64;
+
+            void (*Invoke)(Job& job) = nullptr;
+            void (*Destroy)(Job& job) = nullptr;
+            alignas(std::max_align_t) std::byte Storage[STORAGE_SIZE];
+
+            std::atomic<uint32_t> RefCount = 0; // Held by the job system until the job finishes and by every JobHandle
+            std::atomic<int32_t> PendingDependencies = 0;
+            std::atomic<JobLink*> Dependents = nullptr; // Set to a sentinel once the job has finished
+            Job* Next = nullptr; // Used by inboxes and caches, never while the job is in a deque
+
+            template<typename F>
+            void SetFunction(F&& func)
+            {
+                using Func = std::decay_t<F>;
+
+                if constexpr (sizeof(Func) <= STORAGE_SIZE && alignof(Func) <= alignof(std::max_align_t))
+                {
+                    new (Storage) Func(std::forward<F>(func));
+                    Invoke = [](Job& job) { (*std::launder(reinterpret_cast<Func*>(job.Storage)))(); };
+                    Destroy = [](Job& job) { std::launder(reinterpret_cast<Func*>(job.Storage))->~Func(); };
+                }
+                else
+                {
+                    new (Storage) Func*(new Func(std::forward<F>(func)));
+                    Invoke = [](Job& job) { (**std::launder(reinterpret_cast<Func**>(job.Storage)))(); };
+                    Destroy = [](Job& job) { delete *std::launder(reinterpret_cast<Func**>(job.Storage)); };
+                }
+            }
+
+            NODISCARD bool IsFinished() const;
+
+            static Job* Allocate();
+            static void AddReference(Job* job) { job->RefCount.fetch_add(1, std::memory_order_relaxed); }
+            static void RemoveReference(Job* job);
+        };
+    }
+
+    /**
+     * Reference to a scheduled job, used to wait for the job or to make other jobs depend on it.
+     * Handles keep the job alive, a handle can be checked even long after the job has finished.
+     */
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+        ~JobHandle() { Reset(); }
+
+        JobHandle(const JobHandle& other) : m_Job(other.m_Job) { if (m_Job) Backend::Job::AddReference(m_Job); }
+        JobHandle(JobHandle&& other) noexcept : m_Job(std::exchange(other.m_Job, nullptr)) { }
+
+        JobHandle& operator = (const JobHandle& other)
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Job = other.m_Job;
+                if (m_Job) Backend::Job::AddReference(m_Job);
+            }
+
+            return *this;
+        }
+
+        JobHandle& operator = (JobHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Job = std::exchange(other.m_Job, nullptr);
+            }
+
+            return *this;
+        }
+
+        NODISCARD bool IsValid() const { return m_Job != nullptr; }
+
+        // Null handles count as finished
+        NODISCARD bool IsFinished() const { return !m_Job || m_Job->IsFinished(); }
+
+        void Reset()
+        {
+            if (m_Job)
+                Backend::Job::RemoveReference(std::exchange(m_Job, nullptr));
+        }
+    private:
+        explicit JobHandle(Backend::Job* job) : m_Job(job) { }
+
+        Backend::Job* m_Job = nullptr;
+
+        friend class JobSystem;
+    };
+
+    /**
+     * Work-stealing job scheduler. Every worker thread owns a lock-free deque, jobs scheduled from a worker
+     * go to its own deque and idle workers steal from the others. Jobs scheduled from other threads are
+     * spread over lock-free per-worker inboxes, so no lock is taken on the hot path.
+     *
+     * Jobs may depend on other jobs, a job is queued once all of its dependencies have finished.
+     * Threads that wait for a job execute other jobs in the meantime, waiting from inside a job is allowed.
+     */
+    class JobSystem
+    {
+    public:
+        /**
+         * @param numThreads How many worker threads the job system will have. Pass 0 to use std::thread::hardware_concurrency()
+         */
+        explicit JobSystem(const size_t numThreads = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem& other) = delete;
+        JobSystem& operator = (const JobSystem&) = delete;
+
+        /**
+         * Returns unique std::thread::id of all worker threads
+         */
+        NODISCARD const std::vector<std::thread::id>& GetThreadsIDs() const { return m_ThreadIDs; }
+
+        NODISCARD size_t GetSize() const { return m_WorkerCount; }
+
+        // Index of the calling thread if it's a worker of this job system, otherwise -1
+        NODISCARD int32_t GetCurrentWorkerIndex() const;
+
+        /**
+         * Schedules a job that is executed once all of its dependencies have finished.
+         * With no worker threads the job is executed on the calling thread as soon as it's ready.
+         * @param func The callable object to be executed, callables up to Backend::Job::STORAGE_SIZE bytes are stored without allocations
+         * @param dependencies Jobs that must finish first, null handles are ignored
+         * @return Handle of the job, it can be discarded if the caller tracks completion on its own
+         */
+        template<typename F>
+        JobHandle Schedule(F&& func, std::span<const JobHandle> dependencies = {})
+        {
+            const auto job = Backend::Job::Allocate();
+            job->SetFunction(std::forward<F>(func));
+
+            return Submit(job, dependencies);
+        }
+
+        template<typename F>
+        JobHandle Schedule(F&& func, std::initializer_list<JobHandle> dependencies)
+        {
+            return Schedule(std::forward<F>(func), std::span(dependencies.begin(), dependencies.size()));
+        }
+
+        /**
+         * Blocks until the job has finished, executing other jobs in the meantime
+         */
+        void Wait(const JobHandle& handle);
+        void Wait(std::span<const JobHandle> handles);
+
+        /**
+         * Blocks until all scheduled jobs have finished, including jobs waiting for dependencies
+         */
+        void WaitForAll();
+
+        /**
+         * Executes one queued job on the calling thread
+         * @return False if there was no job to execute
+         */
+        bool TryExecuteJob();
+    private:
+        class Worker;
+
+        JobHandle Submit(Backend::Job* job, std::span<const JobHandle> dependencies);
+        void Enqueue(Backend::Job* job);
+        void Execute(Backend::Job* job);
+        void Finish(Backend::Job* job);
+
+        NODISCARD Backend::Job* FindJob(const int32_t workerIndex);
+        NODISCARD Backend::Job* MoveToDeque(Worker& worker, Backend::Job* jobs);
+        void WorkerLoop(const int32_t workerIndex);
+        void WakeWorkers(const size_t count);
+
+        size_t m_WorkerCount = 0;
+        std::unique_ptr<Worker[]> m_Workers;
+        std::vector<std::thread> m_Threads;
+        std::vector<std::thread::id> m_ThreadIDs;
+
+        std::atomic<size_t> m_NextInbox = 0;
+        std::atomic<int64_t> m_QueuedJobs = 0; // Ready jobs that nobody has started executing yet
+        std::atomic<int64_t> m_UnfinishedJobs = 0;
+
+        std::mutex m_SleepMutex;
+        std::condition_variable m_SleepCondition;
+        std::atomic<uint32_t> m_Sleepers = 0;
+        std::condition_variable m_CompletionCondition;
+        std::atomic<bool> m_ShouldStop = false;
+    };
+}
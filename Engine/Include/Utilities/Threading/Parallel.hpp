@@ -0,0 +1,254 @@
+#pragma once
+
+#include "Core.hpp"
+#include "Utilities/Delegate.hpp"
+#include "Utilities/Threading/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+/**
+ * Data-parallel algorithms running on a JobSystem.
+ *
+ * The calling thread always takes part in the work and the call returns once all of it is done, so loop bodies
+ * may capture locals by reference. Work is claimed in chunks that shrink as the loop progresses, threads that
+ * finish early take over the rest. The grain size is the smallest number of iterations handed out at once,
+ * raise it for cheap loop bodies. Loops with no more than one grain of work run on the calling thread only.
+ * If the body throws, the first exception is rethrown on the calling thread after all other threads have stopped.
+ */
+namespace Rigel
+{
+    namespace Backend
+    {
+        using ParallelBody = Delegate<void(size_t begin, size_t end)>;
+
+        // Keeps the first exception thrown by any thread taking part in a parallel algorithm
+        struct ParallelException
+        {
+            std::atomic_flag Raised;
+            std::exception_ptr Exception;
+
+            void Capture() noexcept
+            {
+                if (!Raised.test_and_set(std::memory_order_acq_rel))
+                    Exception = std::current_exception();
+            }
+
+            // Must only be called once all threads are done
+            void Rethrow() const
+            {
+                if (Exception)
+                    std::rethrow_exception(Exception);
+            }
+        };
+
+        /**
+         * Calls body(begin, end) for disjoint ranges covering [0, count).
+         * If the body throws, no new ranges are handed out and the first exception is rethrown
+         * on the calling thread once every helper has stopped.
+         * @param maxHelpers The maximum number of worker threads that help the calling thread
+         */
+        void ParallelLoop(JobSystem& jobs, const size_t count, const size_t grainSize, const size_t maxHelpers, const ParallelBody& body);
+
+        template<typename F>
+        void ParallelLoop(JobSystem& jobs, const size_t count, const size_t grainSize, const F& body)
+        {
+            ParallelLoop(jobs, count, grainSize, jobs.GetSize(), ParallelBody::FromCallable([&body](const size_t begin, const size_t end)
+            {
+                body(begin, end);
+            }));
+        }
+    }
+
+    /**
+     * Calls func(begin, end) for disjoint batches covering [begin, end), use it when the body is faster on whole batches.
+     */
+    template<typename F>
+    void ParallelForBatch(JobSystem& jobs, const size_t begin, const size_t end, const F& func, const size_t grainSize = 1)
+    {
+        if (begin >= end)
+            return;
+
+        Backend::ParallelLoop(jobs, end - begin, grainSize, [&func, begin](const size_t first, const size_t last)
+        {
+            func(begin + first, begin + last);
+        });
+    }
+
+    /**
+     * Calls func(index) for every index in [begin, end)
+     */
+    template<typename F>
+    void ParallelFor(JobSystem& jobs, const size_t begin, const size_t end, const F& func, const size_t grainSize = 1)
+    {
+        ParallelForBatch(jobs, begin, end, [&func](const size_t first, const size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+                func(i);
+        }, grainSize);
+    }
+
+    /**
+     * Calls func(element) for every element of the range. Spans, vectors and other random access ranges are split
+     * directly. Other containers, such as plf::colony or ObjectPool, are walked by the calling thread, which hands
+     * out batches of grainSize elements as it goes and processes the last batch itself.
+     */
+    template<typename R, typename F> requires requires (R& range) { std::begin(range); std::end(range); }
+    void ParallelForEach(JobSystem& jobs, R&& range, const F& func, const size_t grainSize = 1)
+    {
+        if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>)
+        {
+            const auto first = std::ranges::begin(range);
+
+            ParallelFor(jobs, 0, static_cast<size_t>(std::ranges::size(range)), [&func, &first](const size_t index)
+            {
+                func(first[index]);
+            }, grainSize);
+        }
+        else
+        {
+            const auto grain = std::max<size_t>(grainSize, 1);
+            const auto last = std::end(range);
+            auto batchBegin = std::begin(range);
+            auto handles = std::vector<JobHandle>();
+            auto exception = Backend::ParallelException();
+
+            // Scheduled batches reference func and the range, so they are waited for even if the calling thread throws
+            try
+            {
+                while (batchBegin != last)
+                {
+                    auto batchEnd = batchBegin;
+                    for (size_t i = 0; i < grain && batchEnd != last; ++i)
+                        ++batchEnd;
+
+                    if (batchEnd == last || jobs.GetSize() == 0)
+                    {
+                        for (auto it = batchBegin; it != batchEnd; ++it)
+                            func(*it);
+                    }
+                    else
+                    {
+                        handles.push_back(jobs.Schedule([&func, &exception, batchBegin, batchEnd]
+                        {
+                            try
+                            {
+                                for (auto it = batchBegin; it != batchEnd; ++it)
+                                    func(*it);
+                            }
+                            catch (...)
+                            {
+                                exception.Capture();
+                            }
+                        }));
+                    }
+
+                    batchBegin = batchEnd;
+                }
+            }
+            catch (...)
+            {
+                exception.Capture();
+            }
+
+            jobs.Wait(handles);
+            exception.Rethrow();
+        }
+    }
+
+    /**
+     * Combines map(index) of every index in [begin, end) with reduce(T, T), identity being the neutral element.
+     * The range is split into a fixed number of blocks that are combined in order, so the result doesn't depend on
+     * the timing of threads, even for operations that are not associative like floating point addition.
+     */
+    template<typename T, typename Map, typename Reduce>
+    NODISCARD T ParallelReduce(JobSystem& jobs, const size_t begin, const size_t end, const T& identity,
+        const Map& map, const Reduce& reduce, const size_t grainSize = 1)
+    {
+        if (begin >= end)
+            return identity;
+
+        // A few blocks per thread leave room for balancing blocks that take longer than others
+        constexpr size_t BLOCKS_PER_THREAD = 4;
+
+        const auto count = end - begin;
+        const auto maxBlocks = (jobs.GetSize() + 1) * BLOCKS_PER_THREAD;
+        const auto blockCount = std::clamp<size_t>(count / std::max<size_t>(grainSize, 1), 1, maxBlocks);
+        const auto blockSize = (count + blockCount - 1) / blockCount;
+
+        // Every partial gets its own cache line, this also keeps std::vector<bool> from packing them into shared words
+        struct alignas(64) Partial
+        {
+            T Value;
+        };
+
+        auto partials = std::vector<Partial>(blockCount, Partial{identity});
+
+        Backend::ParallelLoop(jobs, blockCount, 1, [&](const size_t firstBlock, const size_t lastBlock)
+        {
+            for (auto block = firstBlock; block < lastBlock; ++block)
+            {
+                const auto blockBegin = begin + block * blockSize;
+                const auto blockEnd = std::min(blockBegin + blockSize, end);
+
+                auto accumulator = identity;
+                for (auto i = blockBegin; i < blockEnd; ++i)
+                    accumulator = reduce(std::move(accumulator), map(i));
+
+                partials[block].Value = std::move(accumulator);
+            }
+        });
+
+        auto result = identity;
+        for (auto& partial : partials)
+            result = reduce(std::move(result), std::move(partial.Value));
+
+        return result;
+    }
+
+    /**
+     * Sorts the range, the order of equal elements is not preserved.
+     * Blocks of at least grainSize elements are sorted in parallel, then merged pairwise in parallel rounds.
+     */
+    template<std::random_access_iterator It, typename Compare = std::less<>>
+    void ParallelSort(JobSystem& jobs, const It first, const It last, const Compare& compare = {}, const size_t grainSize = 2048)
+    {
+        const auto count = static_cast<size_t>(last - first);
+        const auto maxBlocks = std::bit_ceil(jobs.GetSize() + 1);
+        const auto blockCount = std::min(std::bit_floor(std::max<size_t>(count / std::max<size_t>(grainSize, 1), 1)), maxBlocks);
+
+        if (blockCount <= 1)
+        {
+            std::sort(first, last, compare);
+            return;
+        }
+
+        const auto blockSize = (count + blockCount - 1) / blockCount;
+        const auto bound = [&](const size_t block) { return first + std::min(block * blockSize, count); };
+
+        Backend::ParallelLoop(jobs, blockCount, 1, [&](const size_t firstBlock, const size_t lastBlock)
+        {
+            for (auto block = firstBlock; block < lastBlock; ++block)
+                std::sort(bound(block), bound(block + 1), compare);
+        });
+
+        // Every round merges pairs of sorted runs into runs twice as long, the last round is a single merge
+        for (size_t width = 1; width < blockCount; width *= 2)
+        {
+            Backend::ParallelLoop(jobs, blockCount / (2 * width), 1, [&](const size_t firstPair, const size_t lastPair)
+            {
+                for (auto pair = firstPair; pair < lastPair; ++pair)
+                {
+                    const auto runBegin = pair * 2 * width;
+                    std::inplace_merge(bound(runBegin), bound(runBegin + width), bound(runBegin + 2 * width), compare);
+                }
+            });
+        }
+    }
+}
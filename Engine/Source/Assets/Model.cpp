@@ -1,14 +1,19 @@
 #include "Assets/Model.hpp"
 #include "Subsystems/AssetManager/AssetManager.hpp"
+#include "Subsystems/SubsystemGetters.hpp"
 #include "Backend/Renderer/Vulkan/Helpers/Vertex.hpp"
 #include "Backend/Renderer/Vulkan/Wrapper/VK_VertexBuffer.hpp"
 #include "Backend/Renderer/Vulkan/Wrapper/VK_IndexBuffer.hpp"
 #include "Utilities/Loaders/GLTF_Loader.hpp"
+#include "Utilities/Threading/Parallel.hpp"
 
 namespace Rigel
 {
     using namespace Backend::Vulkan;
 
+    // Vertices transformed by a single task when computing the bounds
+    static constexpr size_t BOUNDS_GRAIN_SIZE = 4096;
+
     Model::NodeIterator::NodeIterator(std::shared_ptr<Backend::ModelNode> root)
         : m_RootNode(std::move(root)), m_CurrentNode(m_RootNode)
     {
@@ -61,6 +66,21 @@ namespace Rigel
             return ErrorCode::FAILED_TO_OPEN_FILE;
         }
 
+        // Node world transforms are computed by the iterator as it descends the node tree, vertices of big meshes are
+        // transformed on the loading threads
+        auto& jobs = GetAssetManager()->GetJobSystem();
+        for (auto nodeIt = GetNodeIterator(); nodeIt.Valid(); nodeIt++)
+        {
+            const auto& world = nodeIt->WorldTransform;
+
+            for (const auto& mesh : nodeIt->Meshes)
+            {
+                m_Bounds.Merge(ParallelReduce(jobs, mesh.FirstVertex, mesh.FirstVertex + mesh.VertexCount, AABB(),
+                    [&world, &vertices](const size_t i) { return AABB::FromPoint(glm::vec3(world * glm::vec4(vertices[i].Position, 1.0f))); },
+                    [](const AABB& lhs, const AABB& rhs) { return AABB::Merge(lhs, rhs); }, BOUNDS_GRAIN_SIZE));
+            }
+        }
+
         m_VertexBuffer = std::make_unique<VK_VertexBuffer>(vertices);
         m_IndexBuffer = std::make_unique<VK_IndexBuffer>(indices);
 
@@ -0,0 +1,83 @@
+#include "Assets/Prefab.hpp"
+#include "ECS/GameObject.hpp"
+#include "Components/Transform.hpp"
+#include "Utilities/Filesystem/File.hpp"
+
+#include "nlohmann_json/json.hpp"
+
+namespace Rigel
+{
+    Prefab::Prefab(const std::filesystem::path& path, const uid_t id) noexcept
+        : RigelAsset(path, id) { }
+    Prefab::~Prefab() = default;
+
+    nlohmann::json Prefab::Serialize(const GOHandle& root)
+    {
+        if (!root.IsValid())
+        {
+            Debug::Error("Failed to serialize a prefab. The root game object handle is invalid!");
+            return {};
+        }
+
+        auto json = nlohmann::json();
+        json["Version"] = 1u;
+        json["GameObjects"] = nlohmann::json::array();
+
+        // Parents are written before their children, which puts the root first
+        auto pending = std::vector<GOHandle>{root};
+        while (!pending.empty())
+        {
+            const auto go = pending.back();
+            pending.pop_back();
+
+            json["GameObjects"].push_back(go->Serialize());
+
+            // Destroyed objects are detached from their parent, a stale child is skipped rather than dereferenced
+            for (const auto& child : go->GetTransform()->GetChildren())
+            {
+                if (child.IsValid())
+                    pending.push_back(child->GetGameObject());
+            }
+        }
+
+        return json;
+    }
+
+    ErrorCode Prefab::Init()
+    {
+        auto file = File::ReadJSON(m_Path);
+        if (file.IsError())
+            return file.GetError();
+
+        auto& json = file.Value();
+
+        if (!json.contains("Version") || !json.contains("GameObjects") || !json["GameObjects"].is_array() || json["GameObjects"].empty())
+            return ErrorCode::NLOHMANN_JSON_READING_ERROR;
+
+        // Currently only one version of prefab json exists
+        if (json["Version"].get<uint32_t>() != 1u)
+            return ErrorCode::ASSET_FILE_FORMAT_NOT_SUPPORTED;
+
+        m_GameObjects = std::make_unique<nlohmann::json>(std::move(json["GameObjects"]));
+        m_ObjectCount = m_GameObjects->size();
+
+        // Must follow the order in which GameObject::DeserializeCopy hands out IDs
+        for (const auto& goJson : *m_GameObjects)
+        {
+            // Scene::Instantiate relies on every object being valid
+            if (!goJson.contains("Components") || !goJson.contains("ID") || !goJson.contains("Name") || !goJson.contains("Active"))
+                return ErrorCode::NLOHMANN_JSON_READING_ERROR;
+
+            m_SerializedIDs.push_back(goJson["ID"].get<uid_t>());
+
+            for (const auto& componentJson : goJson["Components"])
+            {
+                m_SerializedIDs.push_back(componentJson.value("ID", NULL_ID));
+                ++m_ComponentCounts[componentJson.value("Type", std::string())];
+            }
+        }
+
+        m_Initialized = true;
+        return ErrorCode::OK;
+    }
+}
@@ -0,0 +1,67 @@
+#include "Assets/SceneAsset.hpp"
+#include "ECS/Scene.hpp"
+#include "Subsystems/SceneManager.hpp"
+#include "Subsystems/SubsystemGetters.hpp"
+#include "Utilities/Filesystem/File.hpp"
+#include "Utilities/Filesystem/MappedFile.hpp"
+
+#include "nlohmann_json/json.hpp"
+
+namespace Rigel
+{
+    SceneAsset::SceneAsset(const std::filesystem::path& path, const uid_t id) noexcept
+        : RigelAsset(path, id) { }
+
+    SceneAsset::~SceneAsset()
+    {
+        // Scenes that were never adopted still hold their objects and are registered for handle validation
+        if (m_Scene)
+            GetSceneManager()->DestroyDetachedScene(std::move(m_Scene));
+    }
+
+    std::unique_ptr<Scene> SceneAsset::TakeScene()
+    {
+        return std::move(m_Scene);
+    }
+
+    ErrorCode SceneAsset::Init()
+    {
+        const auto file = MappedFile::Open(m_Path);
+        if (file.IsError())
+            return file.GetError();
+
+        // Binary scenes are deserialized straight from the mapped file, anything else is parsed as json
+        if (Backend::BinarySceneFormat::IsBinaryScene(file.Value().GetData()))
+        {
+            auto scene = GetSceneManager()->CreateDetachedScene();
+
+            if (!scene->DeserializeBinary(file.Value().GetData()))
+            {
+                // Reading may fail after some objects were already created
+                GetSceneManager()->DestroyDetachedScene(std::move(scene));
+                return ErrorCode::BINARY_DATA_READING_ERROR;
+            }
+
+            m_Scene = std::move(scene);
+        }
+        else
+        {
+            const auto json = File::ReadJSON(m_Path);
+            if (json.IsError())
+                return json.GetError();
+
+            auto scene = GetSceneManager()->CreateDetachedScene();
+
+            if (!scene->Deserialize(json.Value()))
+            {
+                GetSceneManager()->DestroyDetachedScene(std::move(scene));
+                return ErrorCode::NLOHMANN_JSON_READING_ERROR;
+            }
+
+            m_Scene = std::move(scene);
+        }
+
+        m_Initialized = true;
+        return ErrorCode::OK;
+    }
+}
@@ -38,12 +38,14 @@ namespace Rigel::Backend::Vulkan
         if (!scene.Camera.has_value())
             return;
 
+        ++m_UpdateCount;
+
         // Process models
         uint32_t meshIndex = 0;
         for (uint32_t i = 0; i < scene.Models.size(); ++i)
         {
             const auto& modelAsset = scene.Models[i].Model;
-            const auto& modelTransform = scene.Models[i].Transform;
+            const auto& modelMatrices = GetModelMatrices(scene.Models[i]);
 
             auto deferredBatch = DrawBatch();
             deferredBatch.VertexBuffer = modelAsset->GetVertexBuffer();
@@ -54,10 +56,10 @@ namespace Rigel::Backend::Vulkan
             forwardBatch.IndexBuffer = modelAsset->GetIndexBuffer();
 
             int32_t vertexOffset = 0;
+            size_t nodeIndex = 0;
             for (auto nodeIt = modelAsset->GetNodeIterator(); nodeIt.Valid(); nodeIt++)
             {
-                const auto modelMat = modelTransform * nodeIt->WorldTransform;
-                const auto normalMat = glm::mat3(glm::transpose(glm::inverse(modelMat)));
+                const auto& [modelMat, normalMat] = modelMatrices.Nodes[nodeIndex++];
                 const auto MVP = scene.Camera->ProjView * modelMat;
 
                 for (const auto& mesh : nodeIt->Meshes)
@@ -104,6 +106,12 @@ namespace Rigel::Backend::Vulkan
                 m_ForwardDrawBatches.push_back(forwardBatch);
         }
 
+        // Drop cached matrices of objects that were not rendered this frame
+        std::erase_if(m_ModelMatrices, [this](const auto& entry)
+        {
+            return entry.second.LastUsedUpdate != m_UpdateCount;
+        });
+
         m_SceneData->MeshCount = meshIndex;
         m_SceneData->CameraPosition = scene.Camera->Position;
         // lights, other graphics objects?
@@ -113,6 +121,32 @@ namespace Rigel::Backend::Vulkan
         buffer->UploadData(0, sizeof(SceneData), m_SceneData.get());
     }
 
+    const VK_GPUScene::CachedModelMatrices& VK_GPUScene::GetModelMatrices(const RenderModel& model)
+    {
+        // Object IDs of a scene are dense and far from 2^32, so the lower half of the key is enough for them
+        const auto key = static_cast<uint64_t>(model.SceneID) << 32 | static_cast<uint32_t>(model.TransformID);
+        auto& cached = m_ModelMatrices[key];
+        cached.LastUsedUpdate = m_UpdateCount;
+
+        if (cached.TransformVersion == model.TransformVersion && cached.ModelID == model.Model.GetID())
+            return cached;
+
+        cached.ModelID = model.Model.GetID();
+        cached.TransformVersion = model.TransformVersion;
+        cached.Nodes.clear();
+
+        for (auto nodeIt = model.Model->GetNodeIterator(); nodeIt.Valid(); nodeIt++)
+        {
+            const auto modelMat = model.Transform * nodeIt->WorldTransform;
+            cached.Nodes.push_back({
+                .Model = modelMat,
+                .Normal = glm::mat3(glm::transpose(glm::inverse(modelMat)))
+            });
+        }
+
+        return cached;
+    }
+
     void VK_GPUScene::CreateDescriptorSet()
     {
         // Layout creation
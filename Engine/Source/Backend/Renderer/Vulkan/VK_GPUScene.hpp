@@ -1,15 +1,18 @@
 #pragma once
 
 #include "Core.hpp"
+#include "Math.hpp"
 
 #include "vulkan/vulkan.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace Rigel
 {
     class RenderScene;
+    struct RenderModel;
 }
 
 namespace Rigel::Backend::Vulkan
@@ -63,8 +66,27 @@ namespace Rigel::Backend::Vulkan
         VK_Device& m_Device;
         VK_Swapchain& m_Swapchain;
 
+        // Matrices of every node of a model, computed from the model's world matrix
+        struct CachedModelMatrices
+        {
+            struct NodeMatrices
+            {
+                glm::mat4 Model;
+                glm::mat3 Normal;
+            };
+
+            uid_t ModelID = NULL_ID;
+            uint64_t TransformVersion = 0;
+            uint64_t LastUsedUpdate = 0;
+
+            std::vector<NodeMatrices> Nodes;
+        };
+
         void CreateDescriptorSet();
 
+        // Recomputes the cached matrices only if the transform or the model changed since they were last computed
+        const CachedModelMatrices& GetModelMatrices(const RenderModel& model);
+
         std::unique_ptr<SceneData> m_SceneData;
 
         VkDescriptorSetLayout m_DescriptorSetLayout;
@@ -74,5 +96,9 @@ namespace Rigel::Backend::Vulkan
 
         std::vector<DrawBatch> m_DeferredDrawBatches;
         std::vector<DrawBatch> m_ForwardDrawBatches;
+
+        // Keyed by scene and transform ID, most objects don't move so their normal matrices don't need to be inverted every frame
+        std::unordered_map<uint64_t, CachedModelMatrices> m_ModelMatrices;
+        uint64_t m_UpdateCount = 0;
     };
 }
@@ -77,6 +77,7 @@ namespace Rigel
         json["FOV"] = m_FOV;
         json["Near"] = m_Near;
         json["Far"] = m_Far;
+        json["CullingMask"] = m_CullingMask;
 
         return json;
     }
@@ -100,6 +101,7 @@ namespace Rigel
         m_FOV = json["FOV"].get<float32_t>();
         m_Near = json["Near"].get<float32_t>();
         m_Far = json["Far"].get<float32_t>();
+        m_CullingMask = json.value("CullingMask", ALL_LAYERS); // Optional, older scenes render every layer
         CalcProjection();
 
         return true;
@@ -1,4 +1,5 @@
 #include "Components/ModelRenderer.hpp"
+#include "ECS/Scene.hpp"
 #include "Engine.hpp"
 #include "Subsystems/AssetManager/AssetManager.hpp"
 #include "Subsystems/SubsystemGetters.hpp"
@@ -27,6 +28,14 @@ namespace Rigel
         {
             m_Model = GetAssetManager()->LoadAsync<Model>(m_ModelPath.value());
         }
+
+        // The object's bounds in the spatial index come from the model from now on
+        GetScene()->InvalidateBounds(GetGameObject()->GetTransform());
+    }
+
+    void ModelRenderer::OnDestroy()
+    {
+        GetScene()->InvalidateBounds(GetGameObject()->GetTransform());
     }
 
     nlohmann::json ModelRenderer::Serialize() const
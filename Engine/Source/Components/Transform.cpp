@@ -1,61 +1,69 @@
 #include "Components/Transform.hpp"
 #include "Debug.hpp"
 #include "ECS/Scene.hpp"
-#include "Backend/InternalEvents.hpp"
+#include "ECS/IDRemapTable.hpp"
 #include "Utilities/Serialization/Serializer.hpp"
+#include "Utilities/Serialization/BinaryStream.hpp"
 
 #include "nlohmann_json/json.hpp"
 
 namespace Rigel
 {
     Transform::Transform() : Component(),
-         m_LocalPosition(glm::vec3(0.0f)),
-         m_LocalRotation(glm::identity<glm::quat>()),
-         m_LocalScale(glm::vec3(1.0f)),
-         m_WorldPosition(m_LocalPosition),
-         m_WorldRotation(m_LocalRotation),
-         m_WorldScale(m_LocalScale) { }
+         m_InitialPosition(glm::vec3(0.0f)),
+         m_InitialRotation(glm::identity<glm::quat>()),
+         m_InitialScale(glm::vec3(1.0f)) { }
 
     Transform::Transform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) : Component(),
-        m_LocalPosition(position),
-        m_LocalRotation(rotation),
-        m_LocalScale(scale),
-        m_WorldPosition(m_LocalPosition),
-        m_WorldRotation(m_LocalRotation),
-        m_WorldScale(m_LocalScale) { }
-
-    void Transform::OnLoad()
+        m_InitialPosition(position),
+        m_InitialRotation(rotation),
+        m_InitialScale(scale) { }
+
+    Transform::~Transform()
+    {
+        if (m_Hierarchy)
+            m_Hierarchy->Remove(m_HierarchyIndex);
+    }
+
+    void Transform::AttachToHierarchy(Backend::TransformHierarchy& hierarchy)
     {
-        SubscribeEvent<Backend::TransformUpdateEvent>(&Transform::UpdateOnDemand);
+        m_Hierarchy = &hierarchy;
+        m_HierarchyIndex = hierarchy.Add(this, m_InitialPosition, m_InitialRotation, m_InitialScale);
+    }
 
+    void Transform::OnResolveReferences(const IDRemapTable& table)
+    {
         const auto thisHandle = ComponentHandle(this, this->GetID());
 
         // Convert deserialized children IDs into handles
-        for (auto& child : m_Children)
+        m_Children.reserve(m_SerializedChildren.size());
+        for (const auto childID : m_SerializedChildren)
         {
-            const auto childGenericHandle = GetScene()->FindComponentByID(child.GetID());
+            auto child = table.ResolveComponent<Transform>(childID);
 
-            if (childGenericHandle.IsNull())
+            if (child.IsNull())
             {
-                Debug::Error("A child transform component with ID {} not found!", child.GetID());
+                Debug::Error("A child transform component with ID {} not found!", childID);
                 continue;
             }
 
-            child = childGenericHandle.Cast<Transform>();
             child->m_Parent = thisHandle;
+            GetHierarchy().SetParent(child->m_HierarchyIndex, m_HierarchyIndex);
+            m_Children.push_back(child);
         }
+
+        m_SerializedChildren.clear();
+        m_SerializedChildren.shrink_to_fit();
     }
 
     void Transform::SetLocalPosition(const glm::vec3& position)
     {
-        m_LocalPosition = position;
-        m_UpdateRequiredFlag = true;
+        GetHierarchy().SetLocalPosition(m_HierarchyIndex, position);
     }
 
     void Transform::SetLocalRotation(const glm::quat& rotation)
     {
-        m_LocalRotation = rotation;
-        m_UpdateRequiredFlag = true;
+        GetHierarchy().SetLocalRotation(m_HierarchyIndex, rotation);
     }
 
     void Transform::SetLocalRotation(const glm::vec3& rotation)
@@ -65,107 +73,90 @@ namespace Rigel
 
     void Transform::SetLocalScale(const glm::vec3& scale)
     {
-        m_LocalScale = scale;
-        m_UpdateRequiredFlag = true;
+        GetHierarchy().SetLocalScale(m_HierarchyIndex, scale);
     }
 
-    glm::vec3 Transform::GetPosition()
+    glm::vec3 Transform::GetPosition() const
     {
-        UpdateOnDemand();
-        return m_WorldPosition;
+        return glm::vec3(GetWorldMatrix()[3]);
     }
 
-    glm::quat Transform::GetRotation()
+    glm::quat Transform::GetRotation() const
     {
-        UpdateOnDemand();
-        return m_WorldRotation;
+        // Scale has to be removed from the basis vectors before the rotation can be extracted
+        const auto matrix = glm::mat3(GetWorldMatrix());
+        return glm::quat_cast(glm::mat3(glm::normalize(matrix[0]), glm::normalize(matrix[1]), glm::normalize(matrix[2])));
     }
 
-    glm::vec3 Transform::GetScale()
+    glm::vec3 Transform::GetScale() const
     {
-        UpdateOnDemand();
-        return m_WorldScale;
+        return ExtractWorldScale(GetWorldMatrix());
     }
 
-    glm::vec3 Transform::GetLocalPosition()
+    glm::vec3 Transform::GetLocalPosition() const
     {
-        UpdateOnDemand();
-        return m_LocalPosition;
+        return GetHierarchy().GetLocalPosition(m_HierarchyIndex);
     }
 
-    glm::quat Transform::GetLocalRotation()
+    glm::quat Transform::GetLocalRotation() const
     {
-        UpdateOnDemand();
-        return m_LocalRotation;
+        return GetHierarchy().GetLocalRotation(m_HierarchyIndex);
     }
 
-    glm::vec3 Transform::GetLocalScale()
+    glm::vec3 Transform::GetLocalScale() const
     {
-        UpdateOnDemand();
-        return m_LocalScale;
+        return GetHierarchy().GetLocalScale(m_HierarchyIndex);
     }
 
-    glm::vec3 Transform::GetForwardVector()
+    glm::vec3 Transform::GetForwardVector() const
     {
-        UpdateOnDemand();
-        return m_ForwardVector;
+        // Direction vectors are the normalized basis vectors of the world matrix, no matrix inverse is required
+        return -glm::normalize(glm::vec3(GetWorldMatrix()[2]));
     }
 
-    glm::vec3 Transform::GetRightVector()
+    glm::vec3 Transform::GetRightVector() const
     {
-        UpdateOnDemand();
-        return m_RightVector;
+        return glm::normalize(glm::vec3(GetWorldMatrix()[0]));
     }
 
-    glm::vec3 Transform::GetUpVector()
+    glm::vec3 Transform::GetUpVector() const
     {
-        UpdateOnDemand();
-        return m_UpVector;
+        return glm::normalize(glm::vec3(GetWorldMatrix()[1]));
     }
 
-    glm::mat4 Transform::GetLocalMatrix()
+    glm::mat4 Transform::GetLocalMatrix() const
     {
-        UpdateOnDemand();
-        return m_LocalMatrix;
+        return GetHierarchy().GetLocalMatrix(m_HierarchyIndex);
     }
 
-    glm::mat4 Transform::GetWorldMatrix() // NOLINT(*-no-recursion)
+    glm::mat4 Transform::GetWorldMatrix() const
     {
-        UpdateOnDemand();
-        return m_WorldMatrix;
+        return GetHierarchy().GetWorldMatrix(m_HierarchyIndex);
     }
 
-    void Transform::UpdateOnDemand() // NOLINT(*-no-recursion)
+    uint64_t Transform::GetChangeVersion() const
     {
-        if (m_UpdateRequiredFlag)
-        {
-            UpdateImpl();
-            m_UpdateRequiredFlag = false;
-        }
+        return GetHierarchy().GetChangeVersion(m_HierarchyIndex);
     }
 
-    void Transform::UpdateImpl() // NOLINT(*-no-recursion)
+    void Transform::DetachFromParentAndChildren()
     {
-        m_LocalMatrix = glm::translate(glm::mat4(1.0f), m_LocalPosition);
-        m_LocalMatrix *= glm::mat4_cast(m_LocalRotation);
-        m_LocalMatrix = glm::scale(m_LocalMatrix, m_LocalScale);
-
-        // this will force all transforms up the hierarchy to update, so that we can get an up-to-date world matrix
-        m_WorldMatrix = !m_Parent.IsNull() ? m_Parent->GetWorldMatrix() * m_LocalMatrix : m_LocalMatrix;
-
-        m_WorldPosition = glm::vec3(m_WorldMatrix[3]);
-        m_WorldRotation = glm::quat_cast(m_WorldMatrix);
-        m_WorldScale = ExtractWorldScale(m_WorldMatrix);
+        // Not done through RemoveChild, the dying object's active state doesn't need to be updated
+        if (!m_Parent.IsNull())
+        {
+            std::erase_if(m_Parent->m_Children, [this](const auto& child) { return child.GetID() == GetID(); });
+            m_Parent = ComponentHandle<Transform>::Null();
+        }
 
-        m_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(m_WorldMatrix)));
+        for (auto& child : m_Children)
+        {
+            child->m_Parent = ComponentHandle<Transform>::Null();
+            GetHierarchy().SetParent(child->m_HierarchyIndex, Backend::TransformHierarchy::NO_PARENT);
 
-        m_UpVector = glm::vec3(m_NormalMatrix * glm::vec4(WORLD_UP, 0.0f));
-        m_ForwardVector = glm::vec3(m_NormalMatrix * glm::vec4(WORLD_FORWARD, 0.0f));
-        m_RightVector = glm::vec3(m_NormalMatrix * glm::vec4(WORLD_RIGHT, 0.0f));
+            child->GetGameObject()->UpdateActiveInHierarchy();
+        }
 
-        // if parent component was updated, all it's children must be updated as well
-        for (auto& child : m_Children)
-            child->m_UpdateRequiredFlag = true;
+        m_Children.clear();
     }
 
     glm::vec3 Transform::ExtractWorldScale(const glm::mat4& matrix)
@@ -187,6 +178,13 @@ namespace Rigel
             return;
         }
 
+        // Checked before the transform leaves its current parent, AddChild would reject it afterward
+        if (parent->GetScene().GetID() != GetScene().GetID())
+        {
+            Debug::Error("Cannot parent Transform with ID {} to Transform with ID {}, they are on different scenes!", GetID(), parent.GetID());
+            return;
+        }
+
         if (!m_Parent.IsNull())
             m_Parent->RemoveChild(thisHandle);
 
@@ -201,11 +199,21 @@ namespace Rigel
             return;
         }
 
+        // Hierarchy indices are only meaningful within the scene's own TransformHierarchy
+        if (child->GetScene().GetID() != GetScene().GetID())
+        {
+            Debug::Error("Cannot parent Transform with ID {} to Transform with ID {}, they are on different scenes!", child.GetID(), GetID());
+            return;
+        }
+
         if (auto parent = child->GetParent(); !parent.IsNull())
             parent->RemoveChild(child);
 
         m_Children.push_back(child);
         child->m_Parent = ComponentHandle(this, GetID());
+        GetHierarchy().SetParent(child->m_HierarchyIndex, m_HierarchyIndex);
+
+        child->GetGameObject()->UpdateActiveInHierarchy();
     }
 
     void Transform::RemoveChild(ComponentHandle<Transform>& child)
@@ -221,17 +229,22 @@ namespace Rigel
             return;
         }
 
-        (*it)->m_Parent = ComponentHandle<Transform>::Null();
+        const auto removed = *it;
         m_Children.erase(it);
+
+        removed->m_Parent = ComponentHandle<Transform>::Null();
+        GetHierarchy().SetParent(removed->m_HierarchyIndex, Backend::TransformHierarchy::NO_PARENT);
+
+        removed->GetGameObject()->UpdateActiveInHierarchy();
     }
 
     nlohmann::json Transform::Serialize() const
     {
         auto json = Component::Serialize();
 
-        json["Position"] = Serializer::Serialize(m_LocalPosition);
-        json["Rotation"] = Serializer::Serialize(m_LocalRotation);
-        json["Scale"] = Serializer::Serialize(m_LocalScale);
+        json["Position"] = Serializer::Serialize(GetLocalPosition());
+        json["Rotation"] = Serializer::Serialize(GetLocalRotation());
+        json["Scale"] = Serializer::Serialize(GetLocalScale());
 
         json["Children"] = nlohmann::json::array(); // This insures that json always has 'Children' array field
         for (const auto& child : m_Children)
@@ -257,14 +270,47 @@ namespace Rigel
             return false;
         }
 
-        m_LocalPosition = Serializer::DeserializeVec3(json["Position"]);
-        m_LocalRotation = Serializer::DeserializeQuaternion(json["Rotation"]);
-        m_LocalScale = Serializer::DeserializeVec3(json["Scale"]);
+        // Deserialization happens before the transform is attached to the hierarchy
+        m_InitialPosition = Serializer::DeserializeVec3(json["Position"]);
+        m_InitialRotation = Serializer::DeserializeQuaternion(json["Rotation"]);
+        m_InitialScale = Serializer::DeserializeVec3(json["Scale"]);
 
         // write IDs only because not all objects on the scene are fully deserialized,
         // meaning we can't acquire actual handles yet
         for (const auto& child : json["Children"])
-            m_Children.emplace_back(nullptr, child.get<uid_t>());
+            m_SerializedChildren.push_back(child.get<uid_t>());
+
+        return true;
+    }
+
+    bool Transform::SerializeBinary(BinaryWriter& writer) const
+    {
+        writer.Write(GetLocalPosition());
+        writer.Write(GetLocalRotation());
+        writer.Write(GetLocalScale());
+
+        writer.Write(static_cast<uint32_t>(m_Children.size()));
+        for (const auto& child : m_Children)
+            writer.Write(static_cast<uint64_t>(child.GetID()));
+
+        return true;
+    }
+
+    bool Transform::DeserializeBinary(BinaryReader& reader)
+    {
+        auto childCount = uint32_t(0);
+        auto children = std::vector<uint64_t>();
+
+        reader.Read(m_InitialPosition);
+        reader.Read(m_InitialRotation);
+        reader.Read(m_InitialScale);
+        reader.Read(childCount);
+
+        if (!reader.ReadArray(children, childCount))
+            return false;
+
+        // Resolved the same way as the json children, see OnResolveReferences
+        m_SerializedChildren.assign(children.begin(), children.end());
 
         return true;
     }
@@ -0,0 +1,371 @@
+#include "ECS/BinarySceneFormat.hpp"
+#include "Debug.hpp"
+#include "ECS/Scene.hpp"
+#include "ECS/GameObject.hpp"
+#include "ECS/IDRemapTable.hpp"
+
+#include "nlohmann_json/json.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace Rigel::Backend
+{
+    using namespace HandleValidation;
+
+    static constexpr uint64_t MAX_ID = std::numeric_limits<uid_t>::max();
+
+    std::vector<byte_t> BinarySceneFormat::Write(const Scene& scene)
+    {
+        auto objects = std::vector<ObjectRecord>();
+        objects.reserve(scene.GetSize());
+
+        auto names = std::string();
+
+        // Indexed by ComponentTypeID, pairs of the owner's record index and the component
+        auto componentsByType = std::vector<std::vector<std::pair<uint32_t, const Component*>>>();
+
+        for (const auto& go : scene.m_GameObjects)
+        {
+            const auto objectIndex = static_cast<uint32_t>(objects.size());
+
+            objects.push_back({
+                .ID = go.GetID(),
+                .Tags = go.m_Tags,
+                .Layer = go.m_Layer,
+                .NameSize = static_cast<uint32_t>(go.m_Name.size()),
+                .NameOffset = names.size(),
+                .Active = go.m_Active,
+                .Padding = {}
+            });
+
+            names += go.m_Name;
+
+            for (const auto component : go.GetAttachedComponents())
+            {
+                const auto typeID = component->GetComponentTypeID();
+                if (typeID >= componentsByType.size())
+                    componentsByType.resize(typeID + 1);
+
+                componentsByType[typeID].emplace_back(objectIndex, component);
+            }
+        }
+
+        auto writer = BinaryWriter();
+        writer.Reserve(sizeof(Header) + objects.size() * (sizeof(ObjectRecord) + sizeof(ComponentRecord) + 64) + names.size());
+
+        auto header = Header{};
+        std::memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+        header.Version = VERSION;
+        header.NextObjectID = scene.m_NextObjectID;
+        header.ObjectCount = static_cast<uint32_t>(objects.size());
+        header.BlockCount = 0;
+
+        writer.Write(header);
+        writer.WriteString(scene.m_Name);
+        writer.WriteArray(std::span<const ObjectRecord>(objects));
+        writer.WriteString(names);
+
+        for (const auto& components : componentsByType)
+        {
+            if (components.empty())
+                continue;
+
+            WriteBlock(writer, components);
+            ++header.BlockCount;
+        }
+
+        writer.Overwrite(offsetof(Header, BlockCount), header.BlockCount);
+
+        return writer.TakeBuffer();
+    }
+
+    void BinarySceneFormat::WriteBlock(BinaryWriter& writer, std::span<const std::pair<uint32_t, const Component*>> components)
+    {
+        auto records = std::vector<ComponentRecord>();
+        records.reserve(components.size());
+
+        auto payload = BinaryWriter();
+
+        // Components of the same type either all have a binary format or none of them has one,
+        // the first component decides how the whole block is encoded
+        auto encoding = Encoding::Binary;
+
+        for (const auto& [objectIndex, component] : components)
+        {
+            const auto offset = payload.GetSize();
+
+            if (encoding == Encoding::Binary && !component->SerializeBinary(payload))
+            {
+                if (!records.empty())
+                {
+                    Debug::Error("Component with ID {} has no binary format but other components of type {} do. "
+                                 "The component was not serialized!", component->GetID(), component->GetTypeName());
+                    continue;
+                }
+
+                encoding = Encoding::MessagePack;
+            }
+
+            if (encoding == Encoding::MessagePack)
+            {
+                const auto messagePack = nlohmann::json::to_msgpack(component->Serialize());
+                payload.WriteBytes(messagePack.data(), messagePack.size());
+            }
+
+            records.push_back({
+                .ID = component->GetID(),
+                .PayloadOffset = offset,
+                .PayloadSize = static_cast<uint32_t>(payload.GetSize() - offset),
+                .ObjectIndex = objectIndex,
+                .Active = component->m_Active,
+                .Padding = {}
+            });
+        }
+
+        const auto blockHeader = BlockHeader{
+            .PayloadEncoding = encoding,
+            .ComponentCount = static_cast<uint32_t>(records.size()),
+            .PayloadSize = payload.GetSize()
+        };
+
+        writer.Write(blockHeader);
+        writer.WriteString(components.front().second->GetTypeName());
+        writer.WriteArray(std::span<const ComponentRecord>(records));
+        writer.WriteArray(payload.GetData());
+    }
+
+    bool BinarySceneFormat::Read(Scene& scene, std::span<const byte_t> data)
+    {
+        if (scene.m_Loaded)
+        {
+            Debug::Error("Deserialization on a loaded scene is not allowed. Deserialization aborted!");
+            return false;
+        }
+
+        if (!scene.m_GameObjects.IsEmpty())
+        {
+            Debug::Error("Attempted to deserialized a scene that is not empty! Destroy all objects already instantiated and try again.");
+            return false;
+        }
+
+        if (!IsBinaryScene(data))
+        {
+            Debug::Error("Failed to deserialize Rigel::Scene! The data is not a binary scene.");
+            return false;
+        }
+
+        auto reader = BinaryReader(data);
+        auto header = Header{};
+        auto name = std::string();
+        auto objectRecords = std::vector<ObjectRecord>();
+        auto names = std::string();
+
+        reader.Read(header);
+
+        if (header.Version != VERSION)
+        {
+            Debug::Error("Binary scene version {} is not supported!", header.Version);
+            return false;
+        }
+
+        if (!reader.ReadString(name) || !reader.ReadArray(objectRecords, header.ObjectCount) || !reader.ReadString(names))
+        {
+            Debug::Error("Failed to deserialize Rigel::Scene! The binary scene is truncated.");
+            return false;
+        }
+
+        // Everything the objects are created from is validated before the first one is created, so that a corrupted object table
+        // never leaves a half-built scene. Memory is only reserved for records the file actually contains, header values such as
+        // NextObjectID never size anything
+        if (header.NextObjectID > MAX_ID)
+        {
+            Debug::Error("Failed to deserialize Rigel::Scene! Object IDs of the binary scene don't fit into 32 bits, "
+                         "the engine must be built with RIGEL_USE_64_BIT_ID_TYPE to load it.");
+            return false;
+        }
+
+        for (const auto& record : objectRecords)
+        {
+            if (record.ID == NULL_ID || record.ID >= header.NextObjectID || record.NameOffset > names.size() ||
+                record.NameSize > names.size() - record.NameOffset)
+            {
+                Debug::Error("Failed to deserialize Rigel::Scene! The binary scene contains a corrupted game object record.");
+                return false;
+            }
+        }
+
+        scene.m_Name = std::move(name);
+        scene.m_NextObjectID = static_cast<uid_t>(header.NextObjectID);
+
+        // Everything grows once for all objects instead of once per object
+        scene.m_ObjectIndex.reserve(scene.m_ObjectIndex.size() + objectRecords.size());
+
+        scene.m_GameObjects.Reserve(objectRecords.size());
+        scene.m_TransformHierarchy.Reserve(objectRecords.size());
+
+        auto objects = std::vector<GameObject*>();
+        objects.reserve(objectRecords.size());
+
+        for (const auto& record : objectRecords)
+        {
+            uint32_t poolSlot;
+            const auto go = scene.m_GameObjects.Emplace(poolSlot, static_cast<uid_t>(record.ID), names.substr(record.NameOffset, record.NameSize));
+
+            go->m_PoolSlot = poolSlot;
+            go->m_Scene = SceneHandle(&scene, scene.GetID());
+            go->m_ComponentStorages = &scene.m_ComponentStorages;
+            go->m_Active = record.Active != 0;
+            go->m_ActiveInHierarchy = go->m_Active; // Parents are not known yet, updated once they are
+            go->m_Tags = record.Tags;
+            go->m_Layer = record.Layer;
+
+            if (go->m_Layer >= MAX_LAYERS)
+            {
+                Debug::Error("Game object with ID {} is on layer {}, which doesn't exist. The object was moved to layer 0.", go->GetID(), go->m_Layer);
+                go->m_Layer = 0;
+            }
+
+            objects.push_back(go);
+        }
+
+        // Must be done before any handle to the objects is created, handles copy the slot on construction
+        HandleValidator::AddHandles<HandleType::GOHandle>(std::span(objects));
+
+        auto components = std::vector<Component*>();
+        auto result = true;
+
+        for (uint32_t block = 0; block < header.BlockCount; ++block)
+        {
+            auto blockHeader = BlockHeader{};
+            auto typeName = std::string();
+            auto records = std::vector<ComponentRecord>();
+
+            reader.Read(blockHeader);
+            reader.ReadString(typeName);
+            reader.ReadArray(records, blockHeader.ComponentCount);
+            const auto payload = reader.ReadSpan(blockHeader.PayloadSize);
+
+            // Objects already exist at this point, so the scene keeps the components read so far
+            if (!reader.IsOK())
+            {
+                Debug::Error("Failed to deserialize components of scene {}! The binary scene is truncated.", scene.m_Name);
+                result = false;
+                break;
+            }
+
+            const auto storage = scene.m_ComponentStorages.GetStorage(typeName);
+            if (!storage)
+            {
+                Debug::Error("Failed to deserialize component of type: {}. "
+                             "The type is not registered as a component!", typeName);
+                continue;
+            }
+
+            storage->Reserve(records.size());
+            components.reserve(components.size() + records.size());
+            scene.m_ObjectIndex.reserve(scene.m_ObjectIndex.size() + records.size());
+
+            for (const auto& record : records)
+            {
+                if (record.ObjectIndex >= objects.size() || record.ID == NULL_ID || record.ID >= header.NextObjectID ||
+                    record.PayloadOffset > payload.size() || record.PayloadSize > payload.size() - record.PayloadOffset)
+                {
+                    Debug::Error("Failed to deserialize component of type: {}. The component record is corrupted.", typeName);
+                    continue;
+                }
+
+                const auto go = objects[record.ObjectIndex];
+
+                const auto component = storage->CreateDefault();
+                component->m_Scene = go->m_Scene;
+                component->m_GameObject = GOHandle(go, go->GetID());
+
+                if (!ReadComponentPayload(*component, blockHeader.PayloadEncoding, payload.subspan(record.PayloadOffset, record.PayloadSize)))
+                {
+                    storage->Destroy(component);
+                    continue;
+                }
+
+                const auto typeID = component->GetComponentTypeID();
+                if (typeID < go->m_Components.size() && go->m_Components[typeID])
+                {
+                    Debug::Error("Game object with ID {} has more than one component of type {}. "
+                                 "Only the first one was deserialized.", go->GetID(), typeName);
+                    storage->Destroy(component);
+                    continue;
+                }
+
+                // Record data takes precedence, MessagePack payloads contain the same values
+                component->OverrideID(static_cast<uid_t>(record.ID));
+                component->m_Active = record.Active != 0;
+
+                go->RegisterComponent(component, false);
+                components.push_back(component);
+            }
+        }
+
+        HandleValidator::AddHandles<HandleType::ComponentHandle>(std::span(components));
+
+        // Serialized IDs are kept, the table still has to be built because components resolve references through it
+        auto remapTable = IDRemapTable();
+        remapTable.Reserve(objects.size() + components.size());
+
+        for (const auto go : objects)
+        {
+            scene.IndexGameObject(go);
+            scene.m_TagLayerIndex.Add(go);
+            remapTable.AddGameObject(go->GetID(), go);
+        }
+
+        for (const auto component : components)
+            remapTable.AddComponent(component->GetID(), component);
+
+        for (const auto go : objects)
+            go->ResolveReferences(remapTable);
+
+        // Children of inactive objects become inactive in the hierarchy
+        for (const auto go : objects)
+            go->UpdateActiveInHierarchy();
+
+        return result;
+    }
+
+    bool BinarySceneFormat::ReadComponentPayload(Component& component, const Encoding encoding, std::span<const byte_t> payload)
+    {
+        if (encoding == Encoding::Binary)
+        {
+            auto reader = BinaryReader(payload);
+            if (component.DeserializeBinary(reader) && reader.IsOK())
+                return true;
+
+            Debug::Error("Failed to deserialize component of type: {}. The binary data is invalid.", component.GetTypeName());
+            return false;
+        }
+
+        if (encoding == Encoding::MessagePack)
+        {
+            const auto bytes = reinterpret_cast<const uint8_t*>(payload.data());
+            const auto json = nlohmann::json::from_msgpack(bytes, bytes + payload.size(), true, false);
+
+            if (json.is_discarded())
+            {
+                Debug::Error("Failed to deserialize component of type: {}. The MessagePack data is invalid.", component.GetTypeName());
+                return false;
+            }
+
+            return component.Deserialize(json);
+        }
+
+        Debug::Error("Failed to deserialize component of type: {}. Payload encoding {} is not supported!",
+            component.GetTypeName(), static_cast<uint32_t>(encoding));
+        return false;
+    }
+
+    bool BinarySceneFormat::IsBinaryScene(std::span<const byte_t> data)
+    {
+        return data.size() >= sizeof(Header) && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+    }
+}
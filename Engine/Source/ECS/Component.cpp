@@ -1,11 +1,10 @@
 #include "ECS/Component.hpp"
+#include "ECS/GameObject.hpp"
 #include "Debug.hpp"
 #include "Subsystems/SubsystemGetters.hpp"
 
 #include "nlohmann_json/json.hpp"
 
-#include <ranges>
-
 namespace Rigel
 {
     // The NULL_ID will be overwritten by GameObject::AddComponent method
@@ -16,27 +15,43 @@ namespace Rigel
     {
         if (m_Active == active) return;
 
-        if (m_Active == true && active == false)
-            CallOnDisable();
-        else
-            CallOnEnable();
-
         m_Active = active;
+        UpdateActiveInHierarchy(m_GameObject->IsActiveInHierarchy());
+    }
+
+    void Component::UpdateActiveInHierarchy(const bool ownerActive)
+    {
+        const auto active = m_Active && ownerActive;
+        if (m_ActiveInHierarchy == active) return;
+
+        m_ActiveInHierarchy = active;
+        m_GameObject->m_ComponentStorages->GetStorage(*this).SetActive(this, active);
+
+        // Components that haven't started yet are disabled by CallOnStart
+        if (!m_Loaded)
+            return;
+
+        if (active)
+            CallOnEnable();
+        else
+            CallOnDisable();
     }
 
     void Component::CallOnLoad()
     {
         OnLoad();
-        m_Loaded = true;
     }
 
     void Component::CallOnStart()
     {
         OnStart();
 
+        // Only set here, scenes loaded incrementally run OnStart frames after OnLoad
+        m_Loaded = true;
+
         // This is used to preserve active state after deserialization,
         // note that the component will be disabled AFTER both OnLoad and OnStart ran
-        if (!m_Active)
+        if (!m_ActiveInHierarchy)
             CallOnDisable();
     }
 
@@ -44,27 +59,22 @@ namespace Rigel
     {
         OnDestroy();
 
-        for (const auto& [typeIndex, id] : m_EventsRegistry)
-            GetEventManager()->Unsubscribe(typeIndex, id);
+        for (const auto& [eventID, callbackID] : m_EventsRegistry)
+            GetEventManager()->Unsubscribe(eventID, callbackID);
         m_EventsRegistry.clear();
 
         m_Loaded = false;
     }
 
+    // Event callbacks of the component check m_ActiveInHierarchy themselves, nothing has to be suspended here
     void Component::CallOnEnable()
     {
         OnEnable();
-
-        for (const auto id : m_EventsRegistry | std::views::values)
-            GetEventManager()->SetSuspend(id, false);
     }
 
     void Component::CallOnDisable()
     {
         OnDisable();
-
-        for (const auto id : m_EventsRegistry | std::views::values)
-            GetEventManager()->SetSuspend(id, true);
     }
 
     nlohmann::json Component::Serialize() const
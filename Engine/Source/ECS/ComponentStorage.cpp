@@ -0,0 +1,28 @@
+#include "ECS/ComponentStorage.hpp"
+#include "ECS/Component.hpp"
+
+namespace Rigel::Backend
+{
+    IComponentStorage* ComponentStorageRegistry::GetStorage(const std::string& typeName)
+    {
+        const auto& factories = GetFactories();
+
+        const auto it = factories.find(typeName);
+        if (it == factories.end())
+            return nullptr;
+
+        auto& storage = GetStorageSlot(it->second.ID);
+        if (!storage)
+            storage = it->second.Factory();
+
+        return storage.get();
+    }
+
+    IComponentStorage& ComponentStorageRegistry::GetStorage(const Component& component)
+    {
+        const auto typeID = component.GetComponentTypeID();
+        ASSERT(typeID < m_Storages.size() && m_Storages[typeID], "Component storage not found");
+
+        return *m_Storages[typeID];
+    }
+}
@@ -14,21 +14,92 @@ namespace Rigel
 
     GameObject::GameObject(const uid_t id, std::string name)
         : RigelObject(id), m_Name(std::move(name)) { }
-    GameObject::~GameObject() = default;
+
+    GameObject::~GameObject()
+    {
+        for (const auto component : GetAttachedComponents())
+        {
+            m_Scene->UnindexObject(component->GetID());
+            HandleValidator::RemoveHandle<HandleType::ComponentHandle>(*component);
+            m_ComponentStorages->GetStorage(*component).Destroy(component);
+        }
+    }
 
     void GameObject::SetActive(const bool active)
     {
         if (m_Active == active) return;
 
-        for (const auto& component : m_Components | std::views::values)
-            component->SetActive(active);
-
         m_Active = active;
+        UpdateActiveInHierarchy();
+    }
+
+    void GameObject::UpdateActiveInHierarchy()
+    {
+        // Parents are always updated before their children, so every object can read its parent's cached state.
+        // Subtrees whose state doesn't change are not visited, which makes toggling objects under an inactive parent O(1)
+        auto pending = std::vector<GameObject*>{this};
+
+        while (!pending.empty())
+        {
+            const auto go = pending.back();
+            pending.pop_back();
+
+            const auto transform = go->TryGetComponent<Transform>();
+            const auto parent = transform ? transform->GetParent() : ComponentHandle<Transform>::Null();
+            const auto active = go->m_Active && (parent.IsNull() || parent->GetGameObject()->m_ActiveInHierarchy);
+
+            if (go->m_ActiveInHierarchy == active)
+                continue;
+
+            go->m_ActiveInHierarchy = active;
+
+            for (const auto component : go->GetAttachedComponents())
+                component->UpdateActiveInHierarchy(active);
+
+            if (!transform)
+                continue;
+
+            for (const auto& child : transform->GetChildren())
+                pending.push_back(child->GetGameObject().operator->());
+        }
+    }
+
+    void GameObject::AddTag(const uid_t tag)
+    {
+        if (tag >= MAX_TAGS)
+        {
+            Debug::Error("Failed to add tag {} to game object with ID {}. Tag IDs must be less than {}!", tag, GetID(), MAX_TAGS);
+            return;
+        }
+
+        if (HasTag(tag)) return;
+
+        m_Scene->GetTagLayerIndex().AddTag(this, static_cast<uint32_t>(tag));
+    }
+
+    void GameObject::RemoveTag(const uid_t tag)
+    {
+        if (!HasTag(tag)) return;
+
+        m_Scene->GetTagLayerIndex().RemoveTag(this, static_cast<uint32_t>(tag));
+    }
+
+    void GameObject::SetLayer(const uid_t layer)
+    {
+        if (layer >= MAX_LAYERS)
+        {
+            Debug::Error("Failed to move game object with ID {} to layer {}. Layer IDs must be less than {}!", GetID(), layer, MAX_LAYERS);
+            return;
+        }
+
+        if (m_Layer == layer) return;
+
+        m_Scene->GetTagLayerIndex().SetLayer(this, static_cast<uint32_t>(layer));
     }
 
     void GameObject::OnLoad()
     {
-        for (const auto& component : m_Components | std::views::values)
+        for (const auto& component : GetAttachedComponents())
             component->CallOnLoad();
 
         m_Loaded = true;
@@ -36,23 +107,26 @@ namespace Rigel
 
     void GameObject::OnStart()
     {
-        for (const auto& component : m_Components | std::views::values)
+        // Components of inactive objects disable themselves once started
+        for (const auto& component : GetAttachedComponents())
             component->CallOnStart();
 
-        // This is used to preserve active state after deserialization
-        if (!m_Active)
-        {
-            for (const auto& component : m_Components | std::views::values)
-                component->SetActive(false);
-        }
+        m_Started = true;
     }
 
     void GameObject::OnDestroy()
     {
-        for (const auto& component : m_Components | std::views::values)
+        for (const auto& component : GetAttachedComponents())
             component->CallOnDestroy();
 
         m_Loaded = false;
+        m_Started = false;
+    }
+
+    void GameObject::ResolveReferences(const IDRemapTable& table)
+    {
+        for (const auto& component : GetAttachedComponents())
+            component->OnResolveReferences(table);
     }
 
     uid_t GameObject::AssignIDToComponent(Component* ptr)
@@ -62,6 +136,40 @@ namespace Rigel
         return id;
     }
 
+    void GameObject::RegisterComponent(Component* component, const bool assignHandle)
+    {
+        const auto typeID = component->GetComponentTypeID();
+        // Only grown up to the highest attached type, so an object's memory doesn't depend on how many types the program registers
+        if (typeID >= m_Components.size())
+            m_Components.resize(typeID + 1, nullptr);
+
+        m_Components[typeID] = component;
+        ++m_ComponentCount;
+
+        // Transform data lives in the scene's hierarchy, the transform detaches itself on destruction
+        if (typeID == ComponentTypeID::Get<Transform>())
+            static_cast<Transform*>(component)->AttachToHierarchy(m_Scene->GetTransformHierarchy());
+
+        // Storages create components active, inactive ones are excluded from iteration right away
+        component->m_ActiveInHierarchy = component->m_Active && m_ActiveInHierarchy;
+        if (!component->m_ActiveInHierarchy)
+            m_ComponentStorages->GetStorage(*component).SetActive(component, false);
+
+        if (assignHandle)
+            HandleValidator::AddHandle<HandleType::ComponentHandle>(*component);
+
+        m_Scene->IndexComponent(this, component);
+    }
+
+    void GameObject::UnregisterComponent(Component* component)
+    {
+        m_Scene->UnindexObject(component->GetID());
+        HandleValidator::RemoveHandle<HandleType::ComponentHandle>(*component);
+
+        m_Components[component->GetComponentTypeID()] = nullptr;
+        --m_ComponentCount;
+    }
+
     nlohmann::json GameObject::Serialize() const
     {
         auto json = nlohmann::json();
@@ -69,14 +177,21 @@ namespace Rigel
         json["ID"] = GetID();
         json["Name"] = GetName();
         json["Active"] = m_Active;
+        json["Tags"] = m_Tags;
+        json["Layer"] = m_Layer;
 
-        for (const auto& component : m_Components | std::views::values)
+        for (const auto& component : GetAttachedComponents())
             json["Components"].push_back(component->Serialize());
 
         return json;
     }
 
     bool GameObject::Deserialize(const nlohmann::json& json)
+    {
+        return DeserializeImpl(json, NULL_ID);
+    }
+
+    bool GameObject::DeserializeImpl(const nlohmann::json& json, const uid_t firstID)
     {
         if (!json.contains("Components") || !json.contains("ID") || !json.contains("Name") ||
             !json.contains("Active"))
@@ -86,32 +201,49 @@ namespace Rigel
         }
 
         m_Name = json["Name"].get<std::string>();
-        OverrideID(json["ID"].get<uid_t>());
+        OverrideID(firstID == NULL_ID ? json["ID"].get<uid_t>() : firstID);
         m_Active = json["Active"].get<bool>();
+        m_ActiveInHierarchy = m_Active; // Parents are not known yet, Scene::Deserialize updates the state once they are
+
+        // Optional, scenes saved before tags and layers existed don't have them
+        m_Tags = json.value("Tags", TagMask(0));
+        m_Layer = json.value("Layer", 0u);
+
+        if (m_Layer >= MAX_LAYERS)
+        {
+            Debug::Error("Game object with ID {} is on layer {}, which doesn't exist. The object was moved to layer 0.", GetID(), m_Layer);
+            m_Layer = 0;
+        }
+
+        auto nextID = firstID;
 
         for (const auto& componentJson : json["Components"])
         {
-            const auto typeString = componentJson["Type"].get<std::string>();
-            auto typePtr = TypeRegistry::FindType(typeString);
+            // Copies take the next ID even if the component fails, so IDs of the other components stay predictable
+            const auto componentID = firstID == NULL_ID ? NULL_ID : ++nextID;
+            const auto& typeString = componentJson["Type"].get_ref<const std::string&>();
 
-            if (auto component = std::unique_ptr<Component>(dynamic_cast<Component*>(typePtr.release())))
+            if (const auto storage = m_ComponentStorages->GetStorage(typeString))
             {
+                const auto component = storage->CreateDefault();
                 component->m_Scene = m_Scene;
                 component->m_GameObject = GOHandle(this, this->GetID());
 
                 if (!component->Deserialize(componentJson))
-                    continue; // if deserialization failed, std::unique_ptr will automatically delete the component
+                {
+                    storage->Destroy(component);
+                    continue;
+                }
 
-                // This line acquires type_index of DERIVED class type from a BASE class instance
-                const auto derivedTypeIndex = TYPE_INDEX(*component);
+                if (componentID != NULL_ID)
+                    component->OverrideID(componentID);
 
-                HandleValidator::AddHandle<HandleType::ComponentHandle>(component->GetID());
-                m_Components[derivedTypeIndex] = std::move(component);
+                RegisterComponent(component, componentID == NULL_ID);
             }
             else
             {
-                Debug::Error("Failed to serialize component of type: {}. "
-                             "ComponentTypeRegistry returned nullptr!", typeString);
+                Debug::Error("Failed to deserialize component of type: {}. "
+                             "The type is not registered as a component!", typeString);
             }
         }
 
@@ -0,0 +1,32 @@
+#include "ECS/IDRemapTable.hpp"
+#include "ECS/GameObject.hpp"
+#include "ECS/Component.hpp"
+
+namespace Rigel
+{
+    void IDRemapTable::AddGameObject(const uid_t serializedID, GameObject* gameObject)
+    {
+        m_Entries[serializedID] = {.ObjectPtr = gameObject, .ComponentPtr = nullptr, .ID = gameObject->GetID()};
+    }
+
+    void IDRemapTable::AddComponent(const uid_t serializedID, Component* component)
+    {
+        m_Entries[serializedID] = {.ObjectPtr = nullptr, .ComponentPtr = component, .ID = component->GetID()};
+    }
+
+    GOHandle IDRemapTable::ResolveGameObject(const uid_t serializedID) const
+    {
+        if (const auto entry = FindEntry(serializedID); entry && entry->ObjectPtr)
+            return {entry->ObjectPtr, entry->ID};
+
+        return GOHandle::Null();
+    }
+
+    GenericComponentHandle IDRemapTable::ResolveComponent(const uid_t serializedID) const
+    {
+        if (const auto entry = FindEntry(serializedID); entry && entry->ComponentPtr)
+            return {entry->ComponentPtr, entry->ID};
+
+        return GenericComponentHandle::Null();
+    }
+}
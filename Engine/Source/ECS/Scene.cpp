@@ -1,14 +1,22 @@
 #include "ECS/Scene.hpp"
 #include "ECS/GameObject.hpp"
+#include "ECS/IDRemapTable.hpp"
 #include "Backend/InternalEvents.hpp"
 #include "Components/Transform.hpp"
+#include "Components/ModelRenderer.hpp"
 #include "Handles/HandleValidator.hpp"
 #include "Handles/GOHandle.hpp"
 #include "Subsystems/SubsystemGetters.hpp"
 #include "Subsystems/EventSystem/EventManager.hpp"
+#include "Subsystems/EventSystem/EngineEvents.hpp"
+#include "Subsystems/SystemScheduler/SystemScheduler.hpp"
+#include "ECS/BatchedUpdate.hpp"
+#include "Stopwatch.hpp"
 
 #include "nlohmann_json/json.hpp"
 
+#include <ranges>
+
 namespace Rigel
 {
     using namespace Backend::HandleValidation;
@@ -19,12 +27,18 @@ namespace Rigel
 
     GOHandle Scene::Instantiate(std::string name)
     {
-        const auto go = new GameObject(GetNextObjectID(), std::move(name));
+        uint32_t poolSlot;
+        const auto go = m_GameObjects.Emplace(poolSlot, GetNextObjectID(), std::move(name));
+        go->m_PoolSlot = poolSlot;
         go->m_Scene = SceneHandle(this, this->GetID());
-        go->AddComponent<Transform>();
+        go->m_ComponentStorages = &m_ComponentStorages;
+
+        // Must be done before any handle to the object is created, handles copy the slot on construction
+        HandleValidator::AddHandle<HandleType::GOHandle>(*go);
 
-        HandleValidator::AddHandle<HandleType::GOHandle>(go->GetID());
-        m_GameObjects.emplace(std::unique_ptr<GameObject>(go));
+        go->AddComponent<Transform>();
+        IndexGameObject(go);
+        m_TagLayerIndex.Add(go);
 
         /*
          * If the scene is loaded, appropriate event functions must be invoked
@@ -33,33 +47,167 @@ namespace Rigel
          * Before the scene becomes loaded, all objects on it are NOT instantiated
          */
         if (m_Loaded)
-        {
-            go->OnLoad();
-            go->OnStart();
-        }
+            ActivateGameObjects(std::span(&go, 1));
 
         return {go, go->GetID()};
     }
 
-    void Scene::DestroyGOImpl(const uid_t id)
+    std::vector<GOHandle> Scene::Instantiate(const AssetHandle<Prefab>& prefab, const size_t count)
     {
-        for (auto it = m_GameObjects.begin(); it != m_GameObjects.end(); ++it)
+        auto roots = std::vector<GOHandle>();
+
+        if (prefab.IsNull() || !prefab->IsOK())
         {
-            auto& currentObject = *it;
+            Debug::Error("Failed to instantiate a prefab. The prefab asset is not loaded!");
+            return roots;
+        }
+
+        const auto& objectsJson = prefab->GetGameObjects();
+        const auto& serializedIDs = prefab->GetSerializedIDs();
+        const auto objectsPerInstance = prefab->GetObjectCount();
+        const auto idsPerInstance = serializedIDs.size();
+
+        // Every copy takes a contiguous block of IDs, the index is grown once for all of them
+        const auto firstID = m_NextObjectID;
+        m_NextObjectID += static_cast<uid_t>(count * idsPerInstance);
+        m_ObjectIndex.reserve(m_ObjectIndex.size() + count * idsPerInstance);
+
+        m_GameObjects.Reserve(count * objectsPerInstance);
+        for (const auto& [typeName, typeCount] : prefab->GetComponentCounts())
+        {
+            if (const auto storage = m_ComponentStorages.GetStorage(typeName))
+                storage->Reserve(count * typeCount);
+        }
+
+        auto objects = std::vector<GameObject*>();
+        objects.reserve(count * objectsPerInstance);
+
+        for (size_t i = 0; i < count * objectsPerInstance; ++i)
+        {
+            uint32_t poolSlot;
+            const auto go = m_GameObjects.Emplace(poolSlot, NULL_ID, "");
+            go->m_PoolSlot = poolSlot;
+            go->m_Scene = SceneHandle(this, this->GetID());
+            go->m_ComponentStorages = &m_ComponentStorages;
+
+            objects.push_back(go);
+        }
+
+        // Must be done before any handle to the objects is created, handles copy the slot on construction
+        HandleValidator::AddHandles<HandleType::GOHandle>(std::span(objects));
+
+        // Copies are created in order, so the running ID moves from one copy's block of IDs to the next
+        auto nextID = firstID;
+        auto components = std::vector<Component*>();
 
-            if (currentObject->GetID() == id)
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            const auto go = objects[i];
+            const auto& goJson = objectsJson[i % objectsPerInstance];
+
+            // Can't fail, Prefab::Init made sure all objects have the required data
+            go->DeserializeCopy(goJson, nextID);
+            nextID += static_cast<uid_t>(goJson["Components"].size() + 1);
+
+            IndexGameObject(go);
+            m_TagLayerIndex.Add(go);
+
+            for (const auto component : go->GetAttachedComponents())
+                components.push_back(component);
+        }
+
+        HandleValidator::AddHandles<HandleType::ComponentHandle>(std::span(components));
+
+        // References are resolved per copy, so every copy refers to its own objects.
+        // Entry i of a copy has the copy's first ID + i, which makes rebuilding the table a lookup per entry
+        auto remapTable = IDRemapTable();
+        remapTable.Reserve(idsPerInstance);
+        roots.reserve(count);
+
+        for (size_t instance = 0; instance < count; ++instance)
+        {
+            const auto instanceFirstID = firstID + static_cast<uid_t>(instance * idsPerInstance);
+
+            remapTable.Clear();
+            for (size_t i = 0; i < idsPerInstance; ++i)
             {
-                if (m_Loaded)
-                    currentObject->OnDestroy();
+                const auto entry = FindIndexEntry(instanceFirstID + static_cast<uid_t>(i));
 
-                HandleValidator::AddHandle<HandleType::GOHandle>(currentObject->GetID());
-                m_GameObjects.erase(it);
-                return;
+                if (!entry || !entry->ObjectPtr)
+                    continue;
+
+                if (entry->ComponentPtr)
+                    remapTable.AddComponent(serializedIDs[i], entry->ComponentPtr);
+                else
+                    remapTable.AddGameObject(serializedIDs[i], entry->ObjectPtr);
             }
+
+            for (size_t i = 0; i < objectsPerInstance; ++i)
+                objects[instance * objectsPerInstance + i]->ResolveReferences(remapTable);
+
+            const auto root = objects[instance * objectsPerInstance];
+            roots.emplace_back(root, root->GetID());
+        }
+
+        // Parents come first in prefabs, so a single pass is enough
+        for (const auto go : objects)
+            go->UpdateActiveInHierarchy();
+
+        if (m_Loaded)
+            ActivateGameObjects(objects);
+
+        return roots;
+    }
+
+    void Scene::DestroyGOImpl(const uid_t id, const bool detachTransform)
+    {
+        const auto entry = FindIndexEntry(id);
+
+        if (!entry || !entry->ObjectPtr || entry->ComponentPtr)
+        {
+            Debug::Error("Failed to destroy game object with ID {}. "
+                         "Game object isn't present on the scene with ID {}.", id, this->GetID());
+            return;
         }
 
-        Debug::Error("Failed to destroy game object with ID {}. "
-                     "Game object isn't present on the scene with ID {}.", id, this->GetID());
+        const auto go = entry->ObjectPtr;
+
+        // Objects of an incremental load may not have been loaded yet
+        if (go->m_Loaded)
+            go->OnDestroy();
+
+        // Must be done while the handle is still valid, the index dereferences handles of its members
+        m_TagLayerIndex.Remove(go);
+
+        if (const auto transform = go->TryGetComponent<Transform>())
+        {
+            // Otherwise the parent and the children would keep handles to the destroyed transform
+            if (detachTransform)
+                transform->DetachFromParentAndChildren();
+
+            if (transform->m_SpatialProxy != SpatialIndex::NULL_PROXY)
+                m_SpatialIndex.DestroyProxy(transform->m_SpatialProxy);
+        }
+        HandleValidator::RemoveHandle<HandleType::GOHandle>(*go);
+        UnindexObject(id);
+
+        // Components of the object are removed from the index by the object's destructor
+        m_GameObjects.Erase(go->m_PoolSlot);
+    }
+
+    void Scene::IndexGameObject(GameObject* go)
+    {
+        m_ObjectIndex[go->GetID()] = {.ObjectPtr = go, .ComponentPtr = nullptr};
+    }
+
+    void Scene::IndexComponent(GameObject* owner, Component* component)
+    {
+        m_ObjectIndex[component->GetID()] = {.ObjectPtr = owner, .ComponentPtr = component};
+    }
+
+    void Scene::UnindexObject(const uid_t id)
+    {
+        m_ObjectIndex.erase(id);
     }
 
     void Scene::Destroy(const GOHandle& handle)
@@ -70,7 +218,60 @@ namespace Rigel
             m_DestroyQueue.push(handle);
     }
 
-    void Scene::OnLoad()
+    Ref<SceneCommandBuffer> Scene::CreateCommandBuffer(const uint64_t sortKey)
+    {
+        std::unique_lock lock(m_CommandBuffersMutex);
+        return m_CommandBuffers.emplace_back(new SceneCommandBuffer(sortKey)).get();
+    }
+
+    void Scene::PlaybackCommandBuffers()
+    {
+        auto buffers = std::vector<std::unique_ptr<SceneCommandBuffer>>();
+
+        {
+            std::unique_lock lock(m_CommandBuffersMutex);
+            buffers.swap(m_CommandBuffers);
+        }
+
+        // Stable sort keeps the creation order of buffers with equal keys
+        std::ranges::stable_sort(buffers, {}, [](const auto& buffer) { return buffer->GetSortKey(); });
+
+        for (const auto& buffer : buffers)
+            buffer->Playback(*this);
+    }
+
+    void Scene::ActivateGameObjects(const std::span<GameObject* const> objects)
+    {
+        switch (m_LoadPhase)
+        {
+        case LoadPhase::None:
+            for (const auto go : objects)
+                go->OnLoad();
+            for (const auto go : objects)
+                go->OnStart();
+            break;
+        case LoadPhase::Starting:
+            // OnLoad of the scene's objects is already done, the new ones only wait for their OnStart
+            for (const auto go : objects)
+                go->OnLoad();
+            [[fallthrough]];
+        case LoadPhase::Loading:
+            for (const auto go : objects)
+                m_PendingActivation.emplace_back(go, go->GetID());
+            break;
+        }
+    }
+
+    float32_t Scene::GetLoadProgress() const
+    {
+        if (m_LoadPhase == LoadPhase::None || m_PendingActivation.empty())
+            return 1.0f;
+
+        const auto phaseProgress = static_cast<float32_t>(m_ActivationCursor) / static_cast<float32_t>(m_PendingActivation.size());
+        return m_LoadPhase == LoadPhase::Loading ? phaseProgress * 0.5f : 0.5f + phaseProgress * 0.5f;
+    }
+
+    void Scene::OnLoad(const bool incremental)
     {
         m_Loaded = true;
 
@@ -79,26 +280,176 @@ namespace Rigel
             OnEndOfFrame();
         });
 
+        // A single callback updates every component type that opted into batched updates
+        m_GameUpdateCallbackID = GetEventManager()->Subscribe<GameUpdateEvent>(
+            [this](const GameUpdateEvent&){
+            Backend::BatchedUpdateRegistry::Update(m_ComponentStorages);
+        });
+
+        m_TransformUpdateCallbackID = GetEventManager()->Subscribe<Backend::TransformUpdateEvent>(
+            [this](const Backend::TransformUpdateEvent&){
+            OnTransformUpdate();
+        });
+
+        if (incremental)
+        {
+            // Objects are activated in pool order, same as below, the snapshot keeps the order stable across frames
+            m_PendingActivation.clear();
+            m_PendingActivation.reserve(m_GameObjects.GetSize());
+            for (auto& go : m_GameObjects)
+                m_PendingActivation.emplace_back(&go, go.GetID());
+
+            m_ActivationCursor = 0;
+            m_LoadPhase = LoadPhase::Loading;
+            return;
+        }
+
         // Note that OnStart is called after ALL OnLoad invocations for all GOs,
         // this is extremely critical for proper resource management
-        for (const auto& go : m_GameObjects)
-            go->OnLoad();
-        for (const auto& go : m_GameObjects)
-            go->OnStart();
+        for (auto& go : m_GameObjects)
+            go.OnLoad();
+        for (auto& go : m_GameObjects)
+            go.OnStart();
+    }
+
+    bool Scene::ContinueLoad(const float64_t budget)
+    {
+        if (m_LoadPhase == LoadPhase::None)
+            return true;
+
+        const auto stopwatch = Stopwatch::StartNew();
+
+        do
+        {
+            if (m_ActivationCursor == m_PendingActivation.size())
+            {
+                if (m_LoadPhase == LoadPhase::Starting)
+                {
+                    m_PendingActivation = std::vector<GOHandle>();
+                    m_ActivationCursor = 0;
+                    m_LoadPhase = LoadPhase::None;
+                    return true;
+                }
+
+                // The same guarantee as with regular loading, OnStart only runs once OnLoad ran for every object
+                m_ActivationCursor = 0;
+                m_LoadPhase = LoadPhase::Starting;
+                continue;
+            }
+
+            // Objects destroyed in the meantime are skipped
+            auto& go = m_PendingActivation[m_ActivationCursor++];
+            if (!go.IsValid())
+                continue;
+
+            if (m_LoadPhase == LoadPhase::Loading)
+                go->OnLoad();
+            else
+                go->OnStart();
+        }
+        while (stopwatch.GetElapsed().AsMillisecondsD() < budget);
+
+        return false;
     }
 
     void Scene::OnUnload()
     {
-        for (const auto& go : m_GameObjects)
-            DestroyGOImpl(go->GetID());
+        DestroyAllGameObjects();
 
         GetEventManager()->Unsubscribe<Backend::EndOfFrameEvent>(m_EndOfFrameCallbackID);
+        GetEventManager()->Unsubscribe<GameUpdateEvent>(m_GameUpdateCallbackID);
+        GetEventManager()->Unsubscribe<Backend::TransformUpdateEvent>(m_TransformUpdateCallbackID);
+
+        {
+            // Recorded commands refer to objects that no longer exist
+            std::unique_lock lock(m_CommandBuffersMutex);
+            m_CommandBuffers.clear();
+        }
+
+        m_PendingBounds.clear();
+
+        m_PendingActivation = std::vector<GOHandle>();
+        m_ActivationCursor = 0;
+        m_LoadPhase = LoadPhase::None;
 
         m_Loaded = false;
     }
 
+    void Scene::DestroyAllGameObjects()
+    {
+        // DestroyGOImpl erases from the pool, so the loop can't iterate it directly
+        auto ids = std::vector<uid_t>();
+        ids.reserve(m_GameObjects.GetSize());
+
+        for (const auto& go : m_GameObjects)
+            ids.push_back(go.GetID());
+
+        // Every object goes away, so there is no point in detaching transforms and updating the active state of children
+        for (const auto id : ids)
+            DestroyGOImpl(id, false);
+    }
+
+    void Scene::OnTransformUpdate()
+    {
+        // Gameplay systems are finished by the time transforms are updated, so their threads are free to use
+        m_TransformHierarchy.Update(GetSystemScheduler()->GetJobSystem());
+        UpdateSpatialIndex();
+    }
+
+    void Scene::UpdateSpatialIndex()
+    {
+        // Only transforms that moved this frame are refitted, new transforms are always reported as changed
+        for (const auto& transform : m_TransformHierarchy.GetChangedTransforms())
+        {
+            if (transform.IsValid() && !UpdateBounds(transform))
+                m_PendingBounds.push_back(transform);
+        }
+
+        if (m_PendingBounds.empty())
+            return;
+
+        auto pending = std::vector<ComponentHandle<Transform>>();
+        pending.swap(m_PendingBounds);
+
+        for (const auto& transform : pending)
+        {
+            if (transform.IsValid() && !UpdateBounds(transform))
+                m_PendingBounds.push_back(transform);
+        }
+    }
+
+    bool Scene::UpdateBounds(ComponentHandle<Transform> transform)
+    {
+        const auto world = transform->GetWorldMatrix();
+        auto bounds = AABB::FromPoint(glm::vec3(world[3]));
+        auto final = true;
+
+        // Objects without a model are indexed as points, so that proximity queries find them as well
+        if (const auto renderer = transform->GetGameObject()->TryGetComponent<ModelRenderer>())
+        {
+            if (const auto model = renderer->GetModelAsset(); !model.IsNull())
+            {
+                if (model->IsOK() && !model->GetBounds().IsEmpty())
+                    bounds = model->GetBounds().Transformed(world);
+                else
+                    final = model->IsLoadFinished();
+            }
+        }
+
+        if (transform->m_SpatialProxy == SpatialIndex::NULL_PROXY)
+            transform->m_SpatialProxy = m_SpatialIndex.CreateProxy(transform->GetGameObject(), bounds);
+        else
+            m_SpatialIndex.MoveProxy(transform->m_SpatialProxy, bounds);
+
+        return final;
+    }
+
     void Scene::OnEndOfFrame()
     {
+        // Commands are played back first, so that Destroy commands recorded by worker threads
+        // are processed by the same frame's destroy queue
+        PlaybackCommandBuffers();
+
         // GameObject destruction is deferred until the end of frame to optimize
         // resource and memory management
 
@@ -112,13 +463,40 @@ namespace Rigel
 
     GOHandle Scene::FindGameObjectByID(const uid_t id) const
     {
-        for (const auto& go : m_GameObjects)
+        if (const auto entry = FindIndexEntry(id); entry && entry->ObjectPtr && !entry->ComponentPtr)
+            return {entry->ObjectPtr, id};
+
+        return GOHandle::Null();
+    }
+
+    std::span<const GOHandle> Scene::FindGameObjectsWithTag(const uid_t tag) const
+    {
+        if (tag >= MAX_TAGS)
         {
-            if (go->GetID() == id)
-                return {go.get(), id};
+            Debug::Error("Tag {} doesn't exist, tag IDs must be less than {}!", tag, MAX_TAGS);
+            return {};
         }
 
-        return GOHandle::Null();
+        return m_TagLayerIndex.GetTagMembers(static_cast<uint32_t>(tag));
+    }
+
+    std::span<const GOHandle> Scene::FindGameObjectsInLayer(const uid_t layer) const
+    {
+        if (layer >= MAX_LAYERS)
+        {
+            Debug::Error("Layer {} doesn't exist, layer IDs must be less than {}!", layer, MAX_LAYERS);
+            return {};
+        }
+
+        return m_TagLayerIndex.GetLayerMembers(static_cast<uint32_t>(layer));
+    }
+
+    GenericComponentHandle Scene::FindComponentByID(const uid_t id) const
+    {
+        if (const auto entry = FindIndexEntry(id); entry && entry->ComponentPtr)
+            return {entry->ComponentPtr, id};
+
+        return GenericComponentHandle::Null();
     }
 
     plf::colony<GOHandle> Scene::Search(const std::function<bool(GOHandle&)>& condition, const size_t depthLimit) const
@@ -126,12 +504,12 @@ namespace Rigel
         auto objects = plf::colony<GOHandle>();
         size_t depth = 0;
 
-        for (const auto& go : m_GameObjects)
+        for (auto& go : m_GameObjects)
         {
             if (++depth > depthLimit)
                 return objects;
 
-            auto curHandle = GOHandle(go.get(), go->GetID());
+            auto curHandle = GOHandle(&go, go.GetID());
             if (condition(curHandle))
                 objects.insert(curHandle);
         }
@@ -152,7 +530,7 @@ namespace Rigel
         json["NextObjectID"] = m_NextObjectID;
 
         for (const auto& gameObject : m_GameObjects)
-            json["GameObjects"].push_back(gameObject->Serialize());
+            json["GameObjects"].push_back(gameObject.Serialize());
 
         return json;
     }
@@ -172,7 +550,7 @@ namespace Rigel
             return false;
         }
 
-        if (!m_GameObjects.empty())
+        if (!m_GameObjects.IsEmpty())
         {
             Debug::Error("Attempted to deserialized a scene that is not empty! Destroy all objects already instantiated and try again.");
             return false;
@@ -188,20 +566,45 @@ namespace Rigel
         m_Name = json["Name"].get<std::string>();
         m_NextObjectID = json["NextObjectID"].get<uid_t>();
 
+        // Serialized handles are resolved in a second pass through the remap table,
+        // this keeps loading linear in the number of objects
+        auto remapTable = IDRemapTable();
+        remapTable.Reserve(json["GameObjects"].size());
+
         for (const auto& goJson : json["GameObjects"])
         {
             // Pass empty name and NULL_ID because they will be overridden during deserialization anyway
-            auto go = std::unique_ptr<GameObject>(new GameObject(NULL_ID, ""));
+            uint32_t poolSlot;
+            const auto go = m_GameObjects.Emplace(poolSlot, NULL_ID, "");
 
+            go->m_PoolSlot = poolSlot;
             go->m_Scene = SceneHandle(this, this->GetID());
+            go->m_ComponentStorages = &m_ComponentStorages;
+
+            HandleValidator::AddHandle<HandleType::GOHandle>(*go);
 
             if (!go->Deserialize(goJson))
-                continue; // if deserialization failed, std::unique_ptr will automatically delete the object
+            {
+                HandleValidator::RemoveHandle<HandleType::GOHandle>(*go);
+                m_GameObjects.Erase(poolSlot);
+                continue;
+            }
+
+            remapTable.AddGameObject(go->GetID(), go);
+            for (const auto component : go->GetAttachedComponents())
+                remapTable.AddComponent(component->GetID(), component);
 
-            HandleValidator::AddHandle<HandleType::GOHandle>(go->GetID());
-            m_GameObjects.emplace(std::move(go));
+            IndexGameObject(go);
+            m_TagLayerIndex.Add(go);
         }
 
+        for (auto& go : m_GameObjects)
+            go.ResolveReferences(remapTable);
+
+        // Children of inactive objects become inactive in the hierarchy
+        for (auto& go : m_GameObjects)
+            go.UpdateActiveInHierarchy();
+
         return true;
     }
 }
@@ -0,0 +1,84 @@
+#include "ECS/SceneCommandBuffer.hpp"
+#include "ECS/Scene.hpp"
+
+namespace Rigel
+{
+    SceneCommandBuffer::DeferredGameObject SceneCommandBuffer::Instantiate(std::string name)
+    {
+        const auto deferred = DeferredGameObject{m_InstantiateCount++};
+        m_Commands.push_back({.Type = CommandType::Instantiate, .CommandTarget = Target(deferred), .Name = std::move(name), .Apply = {}});
+
+        return deferred;
+    }
+
+    void SceneCommandBuffer::Destroy(const GOHandle& target)
+    {
+        m_Commands.push_back({.Type = CommandType::Destroy, .CommandTarget = Target(target), .Name = {}, .Apply = {}});
+    }
+
+    void SceneCommandBuffer::Destroy(const DeferredGameObject target)
+    {
+        m_Commands.push_back({.Type = CommandType::Destroy, .CommandTarget = Target(target), .Name = {}, .Apply = {}});
+    }
+
+    void SceneCommandBuffer::SetActive(const GOHandle& target, const bool active)
+    {
+        Record(Target(target), [active](GOHandle& go) { go->SetActive(active); });
+    }
+
+    void SceneCommandBuffer::SetActive(const DeferredGameObject target, const bool active)
+    {
+        Record(Target(target), [active](GOHandle& go) { go->SetActive(active); });
+    }
+
+    void SceneCommandBuffer::Playback(Scene& scene)
+    {
+        // Commands may record new ones into this buffer, so each batch is moved out before it is played back
+        // and whatever was recorded meanwhile is played back as the next batch
+        while (!m_Commands.empty())
+        {
+            auto commands = std::move(m_Commands);
+            const auto instantiateCount = m_InstantiateCount;
+
+            m_Commands.clear();
+            m_InstantiateCount = 0;
+
+            PlaybackBatch(scene, commands, instantiateCount);
+        }
+    }
+
+    void SceneCommandBuffer::PlaybackBatch(Scene& scene, std::vector<Command>& commands, const uint32_t instantiateCount)
+    {
+        auto instantiated = std::vector<GOHandle>(instantiateCount);
+
+        for (auto& command : commands)
+        {
+            if (command.Type == CommandType::Instantiate)
+            {
+                instantiated[command.CommandTarget.DeferredIndex] = scene.Instantiate(std::move(command.Name));
+                continue;
+            }
+
+            // The target might have been destroyed after the command was recorded
+            auto target = Resolve(command.CommandTarget, instantiated);
+            if (!target.IsValid())
+            {
+                Debug::Warning("Skipping a recorded scene command, the target game object no longer exists!");
+                continue;
+            }
+
+            if (command.Type == CommandType::Destroy)
+                scene.Destroy(target);
+            else
+                command.Apply(target);
+        }
+    }
+
+    GOHandle SceneCommandBuffer::Resolve(const Target& target, const std::vector<GOHandle>& instantiated)
+    {
+        if (!target.IsDeferred)
+            return target.Handle;
+
+        return target.DeferredIndex < instantiated.size() ? instantiated[target.DeferredIndex] : GOHandle::Null();
+    }
+}
@@ -0,0 +1,318 @@
+#include "ECS/SpatialIndex.hpp"
+
+#include <algorithm>
+#include <queue>
+
+namespace Rigel
+{
+    // Fat bounds are enlarged by a fraction of the object's size plus a constant, so that both
+    // small and large objects can move a little without being reinserted
+    static constexpr float32_t FAT_BOUNDS_RATIO = 0.1f;
+    static constexpr float32_t FAT_BOUNDS_MARGIN = 0.05f;
+
+    static AABB MakeFatBounds(const AABB& bounds)
+    {
+        const auto extents = bounds.GetExtents();
+        return bounds.Expanded(std::max({extents.x, extents.y, extents.z}) * FAT_BOUNDS_RATIO + FAT_BOUNDS_MARGIN);
+    }
+
+    std::vector<GOHandle> SpatialIndex::FindNearest(const glm::vec3& point, const size_t count, const float32_t maxDistance) const
+    {
+        auto result = std::vector<GOHandle>();
+        if (m_Root == NULL_PROXY || count == 0)
+            return result;
+
+        struct Entry
+        {
+            float32_t DistanceSquared;
+            uint32_t Index;
+
+            bool operator > (const Entry& other) const { return DistanceSquared > other.DistanceSquared; }
+        };
+
+        // Best first search, nodes are expanded in order of their distance to the point.
+        // Leaves come out of the queue sorted as well, so the first count leaves are the nearest objects
+        auto queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<>>();
+        const auto maxDistanceSquared = maxDistance < std::sqrt(std::numeric_limits<float32_t>::max())
+            ? maxDistance * maxDistance : std::numeric_limits<float32_t>::max();
+
+        queue.push({m_Nodes[m_Root].Bounds.DistanceSquared(point), m_Root});
+
+        while (!queue.empty() && result.size() < count)
+        {
+            const auto [distanceSquared, index] = queue.top();
+            queue.pop();
+
+            if (distanceSquared > maxDistanceSquared)
+                break;
+
+            const auto& node = m_Nodes[index];
+            if (node.IsLeaf())
+            {
+                result.push_back(node.Object);
+                continue;
+            }
+
+            queue.push({m_Nodes[node.Child1].Bounds.DistanceSquared(point), node.Child1});
+            queue.push({m_Nodes[node.Child2].Bounds.DistanceSquared(point), node.Child2});
+        }
+
+        return result;
+    }
+
+    uint32_t SpatialIndex::CreateProxy(const GOHandle& object, const AABB& bounds)
+    {
+        const auto proxy = AllocateNode();
+
+        auto& node = m_Nodes[proxy];
+        node.Bounds = MakeFatBounds(bounds);
+        node.Object = object;
+        node.Height = 0;
+
+        InsertLeaf(proxy);
+        ++m_ProxyCount;
+
+        return proxy;
+    }
+
+    void SpatialIndex::DestroyProxy(const uint32_t proxy)
+    {
+        ASSERT(m_Nodes[proxy].IsLeaf(), "Spatial index proxy is not a leaf");
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --m_ProxyCount;
+    }
+
+    bool SpatialIndex::MoveProxy(const uint32_t proxy, const AABB& bounds)
+    {
+        if (m_Nodes[proxy].Bounds.Contains(bounds))
+            return false;
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].Bounds = MakeFatBounds(bounds);
+        InsertLeaf(proxy);
+
+        return true;
+    }
+
+    uint32_t SpatialIndex::AllocateNode()
+    {
+        if (m_FreeList == NULL_PROXY)
+        {
+            m_Nodes.emplace_back();
+            return static_cast<uint32_t>(m_Nodes.size() - 1);
+        }
+
+        const auto index = m_FreeList;
+        m_FreeList = m_Nodes[index].Parent;
+        m_Nodes[index] = Node();
+
+        return index;
+    }
+
+    void SpatialIndex::FreeNode(const uint32_t index)
+    {
+        auto& node = m_Nodes[index];
+        node.Object = GOHandle::Null();
+        node.Height = -1;
+        node.Parent = m_FreeList;
+
+        m_FreeList = index;
+    }
+
+    void SpatialIndex::InsertLeaf(const uint32_t leaf)
+    {
+        if (m_Root == NULL_PROXY)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].Parent = NULL_PROXY;
+            return;
+        }
+
+        // Descend towards the sibling that increases the total surface area of the tree the least
+        const auto leafBounds = m_Nodes[leaf].Bounds;
+        auto index = m_Root;
+
+        while (!m_Nodes[index].IsLeaf())
+        {
+            const auto& node = m_Nodes[index];
+
+            const auto area = node.Bounds.GetHalfArea();
+            const auto combinedArea = AABB::Merge(node.Bounds, leafBounds).GetHalfArea();
+
+            // Cost of making the leaf a sibling of this node, and the cost pushed down to the children otherwise
+            const auto cost = 2.0f * combinedArea;
+            const auto inheritanceCost = 2.0f * (combinedArea - area);
+
+            const auto childCost = [&](const uint32_t child)
+            {
+                const auto& childBounds = m_Nodes[child].Bounds;
+                const auto mergedArea = AABB::Merge(childBounds, leafBounds).GetHalfArea();
+
+                return (m_Nodes[child].IsLeaf() ? mergedArea : mergedArea - childBounds.GetHalfArea()) + inheritanceCost;
+            };
+
+            const auto cost1 = childCost(node.Child1);
+            const auto cost2 = childCost(node.Child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        // Replace the sibling with a new parent of both
+        const auto sibling = index;
+        const auto oldParent = m_Nodes[sibling].Parent;
+        const auto newParent = AllocateNode();
+
+        m_Nodes[newParent].Parent = oldParent;
+        m_Nodes[newParent].Bounds = AABB::Merge(leafBounds, m_Nodes[sibling].Bounds);
+        m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+        m_Nodes[newParent].Child1 = sibling;
+        m_Nodes[newParent].Child2 = leaf;
+
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        if (oldParent == NULL_PROXY)
+            m_Root = newParent;
+        else if (m_Nodes[oldParent].Child1 == sibling)
+            m_Nodes[oldParent].Child1 = newParent;
+        else
+            m_Nodes[oldParent].Child2 = newParent;
+
+        // Refit the ancestors and restore the balance
+        index = m_Nodes[leaf].Parent;
+        while (index != NULL_PROXY)
+        {
+            index = Balance(index);
+
+            auto& node = m_Nodes[index];
+            node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+            node.Bounds = AABB::Merge(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+
+            index = node.Parent;
+        }
+    }
+
+    void SpatialIndex::RemoveLeaf(const uint32_t leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = NULL_PROXY;
+            return;
+        }
+
+        // The sibling takes the place of the parent, which is freed
+        const auto parent = m_Nodes[leaf].Parent;
+        const auto grandParent = m_Nodes[parent].Parent;
+        const auto sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        FreeNode(parent);
+
+        if (grandParent == NULL_PROXY)
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].Parent = NULL_PROXY;
+            return;
+        }
+
+        if (m_Nodes[grandParent].Child1 == parent)
+            m_Nodes[grandParent].Child1 = sibling;
+        else
+            m_Nodes[grandParent].Child2 = sibling;
+
+        m_Nodes[sibling].Parent = grandParent;
+
+        auto index = grandParent;
+        while (index != NULL_PROXY)
+        {
+            index = Balance(index);
+
+            auto& node = m_Nodes[index];
+            node.Bounds = AABB::Merge(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+            node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+
+            index = node.Parent;
+        }
+    }
+
+    uint32_t SpatialIndex::Balance(const uint32_t indexA)
+    {
+        //       A
+        //     /   \
+        //    B     C
+        //   / \   / \
+        //  D   E F   G
+        auto& a = m_Nodes[indexA];
+        if (a.IsLeaf() || a.Height < 2)
+            return indexA;
+
+        const auto indexB = a.Child1;
+        const auto indexC = a.Child2;
+        auto& b = m_Nodes[indexB];
+        auto& c = m_Nodes[indexC];
+
+        const auto balance = c.Height - b.Height;
+
+        // Rotates the taller child 'up' into A's place, A takes the taller grandchild's sibling place
+        const auto rotate = [this, indexA](const uint32_t indexUp, const uint32_t indexOther)
+        {
+            auto& a = m_Nodes[indexA];
+            auto& up = m_Nodes[indexUp];
+
+            const auto indexF = up.Child1;
+            const auto indexG = up.Child2;
+            auto& f = m_Nodes[indexF];
+            auto& g = m_Nodes[indexG];
+
+            up.Child1 = indexA;
+            up.Parent = a.Parent;
+            a.Parent = indexUp;
+
+            if (up.Parent == NULL_PROXY)
+                m_Root = indexUp;
+            else if (m_Nodes[up.Parent].Child1 == indexA)
+                m_Nodes[up.Parent].Child1 = indexUp;
+            else
+                m_Nodes[up.Parent].Child2 = indexUp;
+
+            // The taller grandchild stays under 'up', the shorter one moves under A
+            const auto keepF = f.Height > g.Height;
+            const auto indexKeep = keepF ? indexF : indexG;
+            const auto indexMove = keepF ? indexG : indexF;
+
+            up.Child2 = indexKeep;
+            if (a.Child1 == indexUp)
+                a.Child1 = indexMove;
+            else
+                a.Child2 = indexMove;
+            m_Nodes[indexMove].Parent = indexA;
+
+            const auto& other = m_Nodes[indexOther];
+            const auto& moved = m_Nodes[indexMove];
+
+            a.Bounds = AABB::Merge(other.Bounds, moved.Bounds);
+            a.Height = 1 + std::max(other.Height, moved.Height);
+
+            up.Bounds = AABB::Merge(a.Bounds, m_Nodes[indexKeep].Bounds);
+            up.Height = 1 + std::max(a.Height, m_Nodes[indexKeep].Height);
+        };
+
+        if (balance > 1)
+        {
+            rotate(indexC, indexB);
+            return indexC;
+        }
+
+        if (balance < -1)
+        {
+            rotate(indexB, indexC);
+            return indexB;
+        }
+
+        return indexA;
+    }
+}
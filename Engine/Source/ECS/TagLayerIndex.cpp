@@ -0,0 +1,93 @@
+#include "ECS/TagLayerIndex.hpp"
+#include "ECS/GameObject.hpp"
+
+#include <bit>
+
+namespace Rigel::Backend
+{
+    void TagLayerIndex::Add(GameObject* go)
+    {
+        go->m_TagSlots.clear();
+        for (auto mask = go->m_Tags; mask != 0; mask &= mask - 1)
+        {
+            auto& members = m_TagMembers[std::countr_zero(mask)];
+            go->m_TagSlots.push_back(static_cast<uint32_t>(members.size()));
+            members.emplace_back(go, go->GetID());
+        }
+
+        AddToLayer(go);
+    }
+
+    void TagLayerIndex::Remove(GameObject* go)
+    {
+        // Removing the highest tag first keeps the ranks of the remaining tags valid
+        for (auto mask = go->m_Tags; mask != 0;)
+        {
+            const auto tag = static_cast<uint32_t>(std::bit_width(mask) - 1);
+            EraseTagMember(go, tag);
+            mask &= ~(1ull << tag);
+        }
+
+        RemoveFromLayer(go);
+    }
+
+    void TagLayerIndex::AddTag(GameObject* go, const uint32_t tag)
+    {
+        auto& members = m_TagMembers[tag];
+
+        go->m_Tags |= 1ull << tag;
+        go->m_TagSlots.insert(go->m_TagSlots.begin() + GetTagRank(go, tag), static_cast<uint32_t>(members.size()));
+        members.emplace_back(go, go->GetID());
+    }
+
+    void TagLayerIndex::RemoveTag(GameObject* go, const uint32_t tag)
+    {
+        EraseTagMember(go, tag);
+        go->m_Tags &= ~(1ull << tag);
+    }
+
+    void TagLayerIndex::SetLayer(GameObject* go, const uint32_t layer)
+    {
+        RemoveFromLayer(go);
+        go->m_Layer = layer;
+        AddToLayer(go);
+    }
+
+    void TagLayerIndex::EraseTagMember(GameObject* go, const uint32_t tag)
+    {
+        auto& members = m_TagMembers[tag];
+        const auto rank = GetTagRank(go, tag);
+        const auto slot = go->m_TagSlots[rank];
+
+        // The last member takes the place of the removed one, this may be the removed object itself
+        const auto last = members.back().operator->();
+        members[slot] = members.back();
+        last->m_TagSlots[GetTagRank(last, tag)] = slot;
+        members.pop_back();
+
+        go->m_TagSlots.erase(go->m_TagSlots.begin() + rank);
+    }
+
+    void TagLayerIndex::AddToLayer(GameObject* go)
+    {
+        auto& members = m_LayerMembers[go->m_Layer];
+        go->m_LayerSlot = static_cast<uint32_t>(members.size());
+        members.emplace_back(go, go->GetID());
+    }
+
+    void TagLayerIndex::RemoveFromLayer(GameObject* go)
+    {
+        auto& members = m_LayerMembers[go->m_Layer];
+        const auto slot = go->m_LayerSlot;
+
+        const auto last = members.back().operator->();
+        members[slot] = members.back();
+        last->m_LayerSlot = slot;
+        members.pop_back();
+    }
+
+    uint32_t TagLayerIndex::GetTagRank(const GameObject* go, const uint32_t tag)
+    {
+        return std::popcount(go->m_Tags & ((1ull << tag) - 1));
+    }
+}
@@ -0,0 +1,341 @@
+#include "ECS/TransformHierarchy.hpp"
+#include "Components/Transform.hpp"
+#include "Debug.hpp"
+#include "Utilities/Threading/Parallel.hpp"
+
+#include <algorithm>
+#include <future>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define RIGEL_TRANSFORM_SSE
+    #include <xmmintrin.h>
+#endif
+
+namespace Rigel::Backend
+{
+#pragma region Helpers
+    // Entries processed by a single task, levels smaller than that are processed on the calling thread
+    static constexpr size_t PROPAGATION_BATCH_SIZE = 2048;
+
+    // result = lhs * rhs for column-major matrices, result must not alias the operands
+    static void MultiplyMatrices(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& result)
+    {
+#ifdef RIGEL_TRANSFORM_SSE
+        const auto col0 = _mm_loadu_ps(&lhs[0][0]);
+        const auto col1 = _mm_loadu_ps(&lhs[1][0]);
+        const auto col2 = _mm_loadu_ps(&lhs[2][0]);
+        const auto col3 = _mm_loadu_ps(&lhs[3][0]);
+
+        for (glm::length_t i = 0; i < 4; ++i)
+        {
+            auto column = _mm_mul_ps(col0, _mm_set1_ps(rhs[i][0]));
+            column = _mm_add_ps(column, _mm_mul_ps(col1, _mm_set1_ps(rhs[i][1])));
+            column = _mm_add_ps(column, _mm_mul_ps(col2, _mm_set1_ps(rhs[i][2])));
+            column = _mm_add_ps(column, _mm_mul_ps(col3, _mm_set1_ps(rhs[i][3])));
+            _mm_storeu_ps(&result[i][0], column);
+        }
+#else
+        result = lhs * rhs;
+#endif
+    }
+
+    // Calls func(begin, end) for batches of the range, in parallel if a job system is available
+    template<typename Func>
+    static void ForEachBatch(JobSystem* jobs, const size_t begin, const size_t end, const Func& func)
+    {
+        if (!jobs)
+        {
+            func(begin, end);
+            return;
+        }
+
+        ParallelForBatch(*jobs, begin, end, func, PROPAGATION_BATCH_SIZE);
+    }
+
+    // Shared by all hierarchies, scenes reuse component IDs so versions must not repeat between them
+    static std::atomic<uint64_t> s_NextVersion = 1;
+
+    static uint64_t AcquireVersion()
+    {
+        return s_NextVersion.fetch_add(1, std::memory_order_relaxed);
+    }
+#pragma endregion
+
+    uint32_t TransformHierarchy::Add(Transform* owner, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        const auto index = static_cast<uint32_t>(m_Owners.size());
+
+        m_Owners.push_back(owner);
+        m_Parents.push_back(NO_PARENT);
+        m_LocalPositions.push_back(position);
+        m_LocalRotations.push_back(rotation);
+        m_LocalScales.push_back(scale);
+        m_LocalMatrices.emplace_back(1.0f);
+        m_WorldMatrices.emplace_back(1.0f);
+        m_LocalDirty.push_back(0);
+        m_WorldDirty.push_back(0);
+        m_Versions.push_back(AcquireVersion());
+
+        MarkDirty(index);
+
+        // New entries are roots, appending one keeps the order valid only while every entry is a root
+        if (!m_OrderDirty && m_LevelOffsets.size() <= 2)
+            m_LevelOffsets = {0, index + 1};
+        else
+            m_OrderDirty = true;
+
+        return index;
+    }
+
+    void TransformHierarchy::Reserve(const size_t count)
+    {
+        const auto size = m_Owners.size() + count;
+
+        m_Owners.reserve(size);
+        m_Parents.reserve(size);
+        m_LocalPositions.reserve(size);
+        m_LocalRotations.reserve(size);
+        m_LocalScales.reserve(size);
+        m_LocalMatrices.reserve(size);
+        m_WorldMatrices.reserve(size);
+        m_LocalDirty.reserve(size);
+        m_WorldDirty.reserve(size);
+        m_Versions.reserve(size);
+    }
+
+    void TransformHierarchy::Remove(const uint32_t index)
+    {
+        // Removed entries are compacted by the next Rebuild, so that removing is O(1) and indices stay stable until then
+        m_Owners[index] = nullptr;
+        m_Parents[index] = NO_PARENT;
+
+        ++m_RemovedCount;
+        m_OrderDirty = true;
+    }
+
+    void TransformHierarchy::SetParent(const uint32_t index, const uint32_t parentIndex)
+    {
+        m_Parents[index] = parentIndex;
+        m_OrderDirty = true;
+
+        // The local matrix stays the same, but the world matrix has to be recomputed relative to the new parent
+        MarkDirty(index);
+    }
+
+    glm::mat4 TransformHierarchy::GetLocalMatrix(const uint32_t index) const
+    {
+        return m_LocalDirty[index] ? ComposeLocalMatrix(index) : m_LocalMatrices[index];
+    }
+
+    glm::mat4 TransformHierarchy::GetWorldMatrix(const uint32_t index) const // NOLINT(*-no-recursion)
+    {
+        if (IsWorldMatrixValid(index))
+            return m_WorldMatrices[index];
+
+        const auto parent = GetAliveParent(index);
+        return parent != NO_PARENT ? GetWorldMatrix(parent) * GetLocalMatrix(index) : GetLocalMatrix(index);
+    }
+
+    bool TransformHierarchy::IsWorldMatrixValid(uint32_t index) const
+    {
+        while (true)
+        {
+            if (m_LocalDirty[index])
+                return false;
+
+            const auto parent = m_Parents[index];
+            if (parent == NO_PARENT)
+                return true;
+
+            // The parent was removed, the stored matrix is still relative to it
+            if (!m_Owners[parent])
+                return false;
+
+            index = parent;
+        }
+    }
+
+    glm::mat4 TransformHierarchy::ComposeLocalMatrix(const uint32_t index) const
+    {
+        // Same as translate * mat4_cast(rotation) * scale, without the two full matrix multiplications
+        const auto rotation = glm::mat3_cast(m_LocalRotations[index]);
+        const auto& scale = m_LocalScales[index];
+
+        return {
+            glm::vec4(rotation[0] * scale.x, 0.0f),
+            glm::vec4(rotation[1] * scale.y, 0.0f),
+            glm::vec4(rotation[2] * scale.z, 0.0f),
+            glm::vec4(m_LocalPositions[index], 1.0f)
+        };
+    }
+
+    void TransformHierarchy::Update(JobSystem* jobs)
+    {
+        m_ChangedTransforms.clear();
+
+        if (m_OrderDirty)
+            Rebuild();
+
+        if (!m_AnyDirty.exchange(false, std::memory_order_relaxed))
+            return;
+
+        // Local matrices of changed entries, no dependencies between entries
+        ForEachBatch(jobs, 0, m_Owners.size(), [this](const size_t begin, const size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                if (m_LocalDirty[i])
+                {
+                    m_LocalMatrices[i] = ComposeLocalMatrix(static_cast<uint32_t>(i));
+                    m_LocalDirty[i] = 0;
+                    m_WorldDirty[i] = 1;
+                }
+            }
+        });
+
+        // World matrices level by level, parents of a level were all finished by the previous one
+        for (size_t level = 0; level + 1 < m_LevelOffsets.size(); ++level)
+        {
+            ForEachBatch(jobs, m_LevelOffsets[level], m_LevelOffsets[level + 1], [this](const size_t begin, const size_t end)
+            {
+                for (auto i = begin; i < end; ++i)
+                {
+                    const auto parent = m_Parents[i];
+
+                    if (parent == NO_PARENT)
+                    {
+                        if (m_WorldDirty[i])
+                            m_WorldMatrices[i] = m_LocalMatrices[i];
+                    }
+                    else if (m_WorldDirty[i] || m_WorldDirty[parent])
+                    {
+                        m_WorldDirty[i] = 1;
+                        MultiplyMatrices(m_WorldMatrices[parent], m_LocalMatrices[i], m_WorldMatrices[i]);
+                    }
+                }
+            });
+        }
+
+        // Collecting changes sequentially keeps the list in hierarchy order, parents before their children
+        const auto version = AcquireVersion();
+        for (size_t i = 0; i < m_Owners.size(); ++i)
+        {
+            if (m_WorldDirty[i])
+            {
+                m_Versions[i] = version;
+                m_ChangedTransforms.emplace_back(m_Owners[i], m_Owners[i]->GetID());
+                m_WorldDirty[i] = 0;
+            }
+        }
+    }
+
+    void TransformHierarchy::Rebuild()
+    {
+        const auto count = static_cast<uint32_t>(m_Owners.size());
+        constexpr auto UNKNOWN_DEPTH = std::numeric_limits<uint32_t>::max();
+
+        // Children of removed entries become roots and need their world matrix recomputed
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (m_Owners[i] && m_Parents[i] != NO_PARENT && !m_Owners[m_Parents[i]])
+            {
+                m_Parents[i] = NO_PARENT;
+                MarkDirty(i);
+            }
+        }
+
+        // Depths are resolved by walking up to the nearest entry with a known depth, entries are in arbitrary order here
+        auto depths = std::vector<uint32_t>(count, UNKNOWN_DEPTH);
+        auto chain = std::vector<uint32_t>();
+        uint32_t maxDepth = 0;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!m_Owners[i] || depths[i] != UNKNOWN_DEPTH)
+                continue;
+
+            auto current = i;
+            while (current != NO_PARENT && depths[current] == UNKNOWN_DEPTH)
+            {
+                chain.push_back(current);
+                current = m_Parents[current];
+
+                if (chain.size() > count)
+                {
+                    Debug::Error("A cycle was detected in the transform hierarchy! Transform with ID {} was made a root.", m_Owners[i]->GetID());
+                    m_Parents[i] = NO_PARENT;
+                    current = NO_PARENT;
+                    chain.assign(1, i);
+                    break;
+                }
+            }
+
+            auto depth = current == NO_PARENT ? 0 : depths[current] + 1;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+                depths[*it] = depth++;
+
+            maxDepth = std::max(maxDepth, depth - 1);
+            chain.clear();
+        }
+
+        // Counting sort by depth, stable so that siblings keep their relative order
+        const auto levelCount = count > m_RemovedCount ? maxDepth + 1 : 0;
+        auto levelOffsets = std::vector<uint32_t>(levelCount + 1, 0);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (m_Owners[i])
+                ++levelOffsets[depths[i] + 1];
+        }
+
+        for (uint32_t level = 0; level < levelCount; ++level)
+            levelOffsets[level + 1] += levelOffsets[level];
+
+        auto newIndices = std::vector<uint32_t>(count, NO_PARENT);
+        auto nextSlots = levelOffsets;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (m_Owners[i])
+                newIndices[i] = nextSlots[depths[i]]++;
+        }
+
+        // Permute every array into depth order, dropping removed entries
+        const auto newCount = levelOffsets.back();
+
+        const auto permute = [&]<typename T>(std::vector<T>& data)
+        {
+            auto sorted = std::vector<T>(newCount);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (newIndices[i] != NO_PARENT)
+                    sorted[newIndices[i]] = std::move(data[i]);
+            }
+
+            data = std::move(sorted);
+        };
+
+        permute(m_Owners);
+        permute(m_Parents);
+        permute(m_LocalPositions);
+        permute(m_LocalRotations);
+        permute(m_LocalScales);
+        permute(m_LocalMatrices);
+        permute(m_WorldMatrices);
+        permute(m_LocalDirty);
+        permute(m_Versions);
+        m_WorldDirty.assign(newCount, 0);
+
+        for (uint32_t i = 0; i < newCount; ++i)
+        {
+            if (m_Parents[i] != NO_PARENT)
+                m_Parents[i] = newIndices[m_Parents[i]];
+
+            m_Owners[i]->m_HierarchyIndex = i;
+        }
+
+        m_LevelOffsets = std::move(levelOffsets);
+        m_RemovedCount = 0;
+        m_OrderDirty = false;
+    }
+}
@@ -10,6 +10,7 @@
 #include "Subsystems/WindowManager/WindowManager.hpp"
 #include "Subsystems/Renderer/Renderer.hpp"
 #include "Subsystems/PhysicsEngine/PhysicsEngine.hpp"
+#include "Subsystems/SystemScheduler/SystemScheduler.hpp"
 #include "Utilities/Threading/SleepUtility.hpp"
 #include "Utilities/Filesystem/Directory.hpp"
 
@@ -82,6 +83,7 @@ namespace Rigel
     DEFINE_SUBSYSTEM_GETTER(InputManager)
     DEFINE_SUBSYSTEM_GETTER(Renderer)
     DEFINE_SUBSYSTEM_GETTER(PhysicsEngine)
+    DEFINE_SUBSYSTEM_GETTER(SystemScheduler)
 
     std::unique_ptr<Engine> Engine::CreateInstance()
     {
@@ -112,6 +114,7 @@ namespace Rigel
         m_InputManager = std::make_unique<InputManager>();
         m_Renderer = std::make_unique<Renderer>();
         m_PhysicsEngine = std::make_unique<PhysicsEngine>();
+        m_SystemScheduler = std::make_unique<SystemScheduler>();
 
         // Real startup logic happens here, the order matters A LOT!
         if (!StartUpSubsystem(m_ProjectSettings, m_Time, "Time manager")) return ErrorCode::SUBSYSTEM_STARTUP_FAILURE;
@@ -122,6 +125,7 @@ namespace Rigel
         if (!StartUpSubsystem(m_ProjectSettings, m_InputManager, "Input manager")) return ErrorCode::SUBSYSTEM_STARTUP_FAILURE;
         if (!StartUpSubsystem(m_ProjectSettings, m_Renderer, "Renderer")) return ErrorCode::SUBSYSTEM_STARTUP_FAILURE;
         if (!StartUpSubsystem(m_ProjectSettings, m_PhysicsEngine, "Physics engine")) return ErrorCode::SUBSYSTEM_STARTUP_FAILURE;
+        if (!StartUpSubsystem(m_ProjectSettings, m_SystemScheduler, "System scheduler")) return ErrorCode::SUBSYSTEM_STARTUP_FAILURE;
 
         if (const auto result = m_Renderer->LateStartup(); result != ErrorCode::OK)
         {
@@ -149,6 +153,7 @@ namespace Rigel
         if (m_AssetManager->IsInitialized()) m_AssetManager->UnloadAllAssets();
 
         // Shutdown order matters A LOT!
+        ShutDownSubsystem(m_SystemScheduler, "System scheduler");
         ShutDownSubsystem(m_PhysicsEngine, "Physics engine");
         ShutDownSubsystem(m_Renderer, "Renderer");
         ShutDownSubsystem(m_InputManager, "Input manager");
@@ -194,13 +199,18 @@ namespace Rigel
     void Engine::EngineUpdate() const
     {
         m_WindowManager->PollGLFWEvents();
+        m_EventManager->DeliverPostedEvents();
+        m_SceneManager->Update();
         m_PhysicsEngine->Tick();
-        m_EventManager->Dispatch(GameUpdateEvent(Time::GetDeltaTime(), Time::GetFrameCount()));
+        const auto updateEvent = GameUpdateEvent(Time::GetDeltaTime(), Time::GetFrameCount());
+        m_EventManager->Dispatch(updateEvent);
+        m_SystemScheduler->Update(updateEvent);
         m_EventManager->Dispatch(Backend::TransformUpdateEvent());
         m_Renderer->Render();
 
         m_InputManager->ResetInputState();
         m_EventManager->Dispatch(Backend::EndOfFrameEvent());
+        m_SceneManager->OnEndOfFrame();
     }
 
     void Engine::DrawDebugGUI()
@@ -1,18 +1,8 @@
 #include "Handles/SceneHandle.hpp"
-#include "Handles/HandleValidator.hpp"
+#include "ECS/Scene.hpp"
 
 namespace Rigel
 {
+    // Defined here because Scene must be complete to copy its handle slot
     SceneHandle::SceneHandle(Scene* ptr, const uid_t id) : RigelHandle(ptr, id) { }
-
-    bool SceneHandle::IsNull() const
-    {
-        return m_Ptr == nullptr || m_ID == NULL_ID;
-    }
-
-    bool SceneHandle::IsValid() const
-    {
-        using namespace Backend::HandleValidation;
-        return HandleValidator::Validate<HandleType::SceneHandle>(m_ID);
-    }
 }
@@ -4,12 +4,14 @@
 
 namespace Rigel::Backend
 {
-    AssetDeleter::AssetDeleter(RigelAsset* ptr)
-        : m_Asset(ptr) { }
+    void AssetDeleter::AddReference(RigelAsset* asset)
+    {
+        asset->m_RefCount.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    AssetDeleter::~AssetDeleter()
+    void AssetDeleter::RemoveReference(RigelAsset* asset)
     {
-        if (!m_Asset->m_IsPersistent)
-            GetAssetManager()->Unload(m_Asset->GetID());
+        if (asset->m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && !asset->m_IsPersistent)
+            GetAssetManager()->Unload(asset->GetID());
     }
 }
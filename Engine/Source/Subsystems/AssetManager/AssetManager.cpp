@@ -14,9 +14,9 @@ namespace Rigel
         Debug::Trace("Starting up asset manager.");
 
         m_EnableAssetLifetimeLogging = settings.EnableAssetLifetimeLogging;
-        m_ThreadPool = std::make_unique<ThreadPool>(settings.AssetManagerThreadPoolSize);
+        m_JobSystem = std::make_unique<JobSystem>(settings.AssetManagerThreadPoolSize);
 
-        Debug::Trace("Created asset manager thread pool with {} threads.", m_ThreadPool->GetSize());
+        Debug::Trace("Created asset manager job system with {} threads.", m_JobSystem->GetSize());
 
         m_Initialized = true;
         return ErrorCode::OK;
@@ -31,7 +31,7 @@ namespace Rigel
 
     void AssetManager::Unload(const uid_t assetID)
     {
-        m_ThreadPool->Enqueue([this, assetID]
+        m_JobSystem->Schedule([this, assetID]
         {
             std::unique_ptr<RigelAsset> assetPtr;
             std::filesystem::path path;
@@ -88,10 +88,10 @@ namespace Rigel
 
         for (const auto id : normalAssets)
             Unload(id);
-        m_ThreadPool->WaitForAll();
+        m_JobSystem->WaitForAll();
 
         for (const auto id : persistentAssets)
             Unload(id);
-        m_ThreadPool->WaitForAll();
+        m_JobSystem->WaitForAll();
     }
 }
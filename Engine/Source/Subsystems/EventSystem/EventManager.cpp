@@ -1,5 +1,10 @@
 #include "Subsystems/EventSystem/EventManager.hpp"
 #include "Debug.hpp"
+#include "Utilities/Threading/Parallel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
 
 namespace Rigel
 {
@@ -16,4 +21,256 @@ namespace Rigel
         Debug::Trace("Shutting down event manager.");
         return ErrorCode::OK;
     }
+
+    EventManager::CallbackID EventManager::AddSubscriber(const type_id_t eventTypeID, const Callback& callback)
+    {
+        if (eventTypeID >= m_Subscribers.size())
+            m_Subscribers.resize(eventTypeID + 1);
+
+        auto& subscribers = m_Subscribers[eventTypeID];
+        const auto id = m_NextCallbackID++;
+        const auto index = static_cast<uint32_t>(subscribers.GetSize());
+
+        subscribers.Thunks.push_back(callback.GetThunk());
+        subscribers.Instances.push_back(callback.GetInstance());
+        subscribers.Storages.push_back(callback.GetStorage());
+        subscribers.IDs.push_back(id);
+
+        if (index / 64 >= subscribers.SuspendBits.size())
+            subscribers.SuspendBits.push_back(0);
+        subscribers.SetSuspended(index, false);
+
+        m_Callbacks[id] = {eventTypeID, index};
+
+        return id;
+    }
+
+    void EventManager::SetSuspend(const CallbackID id, const bool state)
+    {
+        const auto it = m_Callbacks.find(id);
+        if (it == m_Callbacks.end())
+        {
+            Debug::Error("Attempted to suspend an event callback with invalid ID {}!", id);
+            return;
+        }
+
+        m_Subscribers[it->second.EventTypeID].SetSuspended(it->second.Index, state);
+    }
+
+    void EventManager::Unsubscribe(const type_id_t eventTypeID, const CallbackID id)
+    {
+        if (id == NULL_ID) return;
+
+        const auto it = m_Callbacks.find(id);
+        if (it == m_Callbacks.end() || it->second.EventTypeID != eventTypeID)
+            return;
+
+        const auto index = it->second.Index;
+        m_Callbacks.erase(it);
+
+        auto& subscribers = m_Subscribers[eventTypeID];
+
+        // Moving callbacks around while they are being dispatched would make the dispatch skip some of them
+        if (subscribers.DispatchDepth > 0)
+        {
+            subscribers.SetSuspended(index, true);
+            subscribers.IDs[index] = NULL_ID;
+            subscribers.PendingRemovals.push_back(index);
+            return;
+        }
+
+        RemoveSubscriber(subscribers, index);
+    }
+
+    void EventManager::RemoveSubscriber(SubscriberList& subscribers, const uint32_t index)
+    {
+        const auto last = static_cast<uint32_t>(subscribers.GetSize() - 1);
+
+        if (index != last)
+        {
+            subscribers.Thunks[index] = subscribers.Thunks[last];
+            subscribers.Instances[index] = subscribers.Instances[last];
+            subscribers.Storages[index] = subscribers.Storages[last];
+            subscribers.IDs[index] = subscribers.IDs[last];
+            subscribers.SetSuspended(index, subscribers.IsSuspended(last));
+
+            // Callbacks pending removal have no entry anymore
+            if (const auto it = m_Callbacks.find(subscribers.IDs[index]); it != m_Callbacks.end())
+                it->second.Index = index;
+        }
+
+        subscribers.Thunks.pop_back();
+        subscribers.Instances.pop_back();
+        subscribers.Storages.pop_back();
+        subscribers.IDs.pop_back();
+        subscribers.SetSuspended(last, false);
+
+        if (last % 64 == 0)
+            subscribers.SuspendBits.pop_back();
+    }
+
+    void EventManager::EndDispatch(SubscriberList& subscribers)
+    {
+        if (--subscribers.DispatchDepth > 0 || subscribers.PendingRemovals.empty())
+            return;
+
+        // Removing the highest indices first guarantees that the callback swapped into a removed slot
+        // is never one that is still waiting for removal itself
+        std::ranges::sort(subscribers.PendingRemovals, std::greater());
+        for (const auto index : subscribers.PendingRemovals)
+            RemoveSubscriber(subscribers, index);
+
+        subscribers.PendingRemovals.clear();
+    }
+
+    // Callbacks below this count are never split between threads, scheduling them would cost more than running them
+    static constexpr size_t MIN_DISPATCH_CHUNK = 16;
+
+    void EventManager::DispatchThreaded(SubscriberList& subscribers, const Event& event, JobSystem& jobs, const size_t helpers)
+    {
+        ++subscribers.DispatchDepth;
+
+        Backend::ParallelLoop(jobs, subscribers.GetSize(), MIN_DISPATCH_CHUNK, helpers,
+            Backend::ParallelBody::FromCallable([&subscribers, &event](const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (subscribers.IsSuspended(i))
+                    continue;
+
+                const auto storage = subscribers.Storages[i];
+                subscribers.Thunks[i](subscribers.Instances[i], storage, event);
+            }
+        }));
+
+        EndDispatch(subscribers);
+    }
+
+    void EventManager::DeliverPostedEvents()
+    {
+        const auto index = m_ActivePostQueue.load(std::memory_order_relaxed);
+        auto& queue = m_PostQueues[index];
+
+        m_ActivePostQueue.store(1 - index, std::memory_order_seq_cst);
+
+        // Producers that picked the queue before the swap are finishing their posts, which only takes a moment
+        while (queue.Writers.load(std::memory_order_seq_cst) != 0)
+            std::this_thread::yield();
+
+        const auto events = queue.TakeAll();
+
+        for (auto posted = events; posted; posted = posted->Next)
+            m_DeliveryBuffer.push_back(posted);
+
+        // The stack holds the most recent event first, stable sorting the reversed buffer keeps the posting order within a type
+        std::ranges::reverse(m_DeliveryBuffer);
+        std::ranges::stable_sort(m_DeliveryBuffer, std::less(), &PostedEvent::EventTypeID);
+
+        for (const auto posted : m_DeliveryBuffer)
+            posted->Deliver(*this, *posted->EventPtr);
+
+        m_DeliveryBuffer.clear();
+        queue.Reset(events);
+    }
+
+    EventManager::PostQueue& EventManager::BeginPost()
+    {
+        while (true)
+        {
+            auto& queue = m_PostQueues[m_ActivePostQueue.load(std::memory_order_seq_cst)];
+            queue.Writers.fetch_add(1, std::memory_order_seq_cst);
+
+            // Either the main thread sees the writer and waits for it, or the writer sees the swap and retries
+            if (&queue == &m_PostQueues[m_ActivePostQueue.load(std::memory_order_seq_cst)])
+                return queue;
+
+            queue.Writers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void EventManager::EndPost(PostQueue& queue, PostedEvent* event)
+    {
+        queue.Push(event);
+        queue.Writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    EventManager::PostQueue::~PostQueue()
+    {
+        DestroyEvents(TakeAll());
+        FreeBlocks(m_Blocks.load(std::memory_order_relaxed));
+    }
+
+    byte_t* EventManager::PostQueue::Allocate(size_t size)
+    {
+        size = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        while (true)
+        {
+            auto block = m_Blocks.load(std::memory_order_acquire);
+
+            if (block)
+            {
+                // Offsets of full blocks keep growing past the capacity, which is harmless
+                const auto offset = block->Offset.fetch_add(size, std::memory_order_relaxed);
+                if (offset + size <= block->Capacity)
+                    return block->GetData() + offset;
+            }
+
+            // The block is full, the thread that manages to install a new one continues with it, the others retry
+            const auto capacity = std::max(BLOCK_SIZE, size);
+            const auto newBlock = new (::operator new(BLOCK_HEADER_SIZE + capacity)) Block{block, capacity, size};
+
+            if (m_Blocks.compare_exchange_strong(block, newBlock, std::memory_order_acq_rel))
+                return newBlock->GetData();
+
+            newBlock->~Block();
+            ::operator delete(newBlock);
+        }
+    }
+
+    void EventManager::PostQueue::Push(PostedEvent* event)
+    {
+        event->Next = m_Head.load(std::memory_order_relaxed);
+        while (!m_Head.compare_exchange_weak(event->Next, event, std::memory_order_release, std::memory_order_relaxed)) { }
+    }
+
+    void EventManager::PostQueue::Reset(PostedEvent* events)
+    {
+        DestroyEvents(events);
+
+        const auto block = m_Blocks.load(std::memory_order_relaxed);
+        if (!block)
+            return;
+
+        if (!block->Next)
+        {
+            block->Offset.store(0, std::memory_order_relaxed);
+            return;
+        }
+
+        // Events outgrew the memory this frame, the blocks are replaced by a single one big enough for all of them
+        auto capacity = size_t(0);
+        for (auto current = block; current; current = current->Next)
+            capacity += current->Capacity;
+
+        FreeBlocks(block);
+        m_Blocks.store(new (::operator new(BLOCK_HEADER_SIZE + capacity)) Block{nullptr, capacity, 0}, std::memory_order_relaxed);
+    }
+
+    void EventManager::PostQueue::DestroyEvents(PostedEvent* events)
+    {
+        for (auto posted = events; posted; posted = posted->Next)
+            posted->EventPtr->~Event();
+    }
+
+    void EventManager::PostQueue::FreeBlocks(Block* blocks)
+    {
+        while (blocks)
+        {
+            const auto next = blocks->Next;
+            blocks->~Block();
+            ::operator delete(blocks);
+            blocks = next;
+        }
+    }
 }
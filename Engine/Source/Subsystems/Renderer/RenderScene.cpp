@@ -2,45 +2,91 @@
 #include "ECS/Scene.hpp"
 #include "Handles/SceneHandle.hpp"
 #include "Components/Camera.hpp"
+#include "Components/Transform.hpp"
 #include "Components/ModelRenderer.hpp"
 #include "Components/DirectionalLight.hpp"
 #include "Components/PointLight.hpp"
 #include "Components/SpotLight.hpp"
+#include "Utilities/Threading/Parallel.hpp"
 
 namespace Rigel
 {
-    RenderScene RenderScene::Extract(const SceneHandle& scene)
+    // Checking a candidate is cheap, smaller batches would cost more in scheduling than they save
+    static constexpr size_t EXTRACTION_GRAIN_SIZE = 256;
+
+    RenderScene RenderScene::Extract(const std::span<const SceneHandle> scenes, JobSystem& jobs)
     {
         auto renderScene = RenderScene();
 
-        if (scene.IsNull())
-            return renderScene;
-
         // Camera
-        if (const auto cameras = scene->FindComponentsOfType<Rigel::Camera>(); cameras.empty())
-            return renderScene;
-        else
+        auto cullingMask = LayerMask();
+        for (const auto& scene : scenes)
         {
-            auto camera = cameras[0];
+            const auto cameras = scene->Query<Rigel::Camera, Transform>();
+            if (cameras.IsEmpty())
+                continue;
+
+            auto [camera, cameraTransform] = cameras.Front();
             renderScene.Camera = {
-                .Position = camera->GetGameObject()->GetTransform()->GetPosition(),
+                .Position = cameraTransform->GetPosition(),
                 .ProjView = camera->GetProjection() * camera->GetView()
             };
+
+            cullingMask = camera->GetCullingMask();
+            break;
         }
 
-        // Model renderer
-        for (const auto& mr : scene->FindComponentsOfType<ModelRenderer>())
+        if (!renderScene.Camera)
+            return renderScene;
+
+        // Model renderer, only objects inside the camera's frustum are extracted. The spatial index is queried on the calling
+        // thread, checking the candidates and reading their world matrices is spread over the job system
+        struct Candidate
         {
-            if (const auto asset = mr->GetModelAsset(); !asset.IsNull() && asset->IsOK())
+            GOHandle GameObject;
+            uid_t SceneID;
+        };
+
+        const auto frustum = Frustum::FromMatrix(renderScene.Camera->ProjView);
+        auto candidates = std::vector<Candidate>();
+
+        for (const auto& scene : scenes)
+        {
+            scene->GetSpatialIndex().QueryFrustum(frustum, [&](const GOHandle& go)
+            {
+                if (go->GetLayerMask() & cullingMask)
+                    candidates.emplace_back(go, scene.GetID());
+            });
+
+            // Directional light
+            for (const auto& [dirLight] : scene->Query<DirectionalLight>())
             {
-                renderScene.Models.emplace_back(asset, mr->GetGameObject()->GetTransform()->GetWorldMatrix());
+                renderScene.DirectionalLights.emplace_back(dirLight->Direction, dirLight->Color, dirLight->Intensity, dirLight->CastShadows);
             }
         }
 
-        // Directional light
-        for (const auto& dirLight : scene->FindComponentsOfType<DirectionalLight>())
+        // Every candidate writes its own slot, compacting them afterwards keeps the order of the query
+        auto models = std::vector<std::optional<RenderModel>>(candidates.size());
+        ParallelFor(jobs, 0, candidates.size(), [&candidates, &models](const size_t index)
+        {
+            const auto& [go, sceneID] = candidates[index];
+
+            const auto mr = go->TryGetComponent<ModelRenderer>();
+            if (mr == nullptr || !mr->IsActiveInHierarchy())
+                return;
+
+            if (const auto asset = mr->GetModelAsset(); !asset.IsNull() && asset->IsOK())
+            {
+                const auto transform = go->GetTransform();
+                models[index].emplace(asset, transform->GetWorldMatrix(), sceneID, transform->GetID(), transform->GetChangeVersion());
+            }
+        }, EXTRACTION_GRAIN_SIZE);
+
+        renderScene.Models.reserve(models.size());
+        for (auto& model : models)
         {
-            renderScene.DirectionalLights.emplace_back(dirLight->Direction, dirLight->Color, dirLight->Intensity, dirLight->CastShadows);
+            if (model)
+                renderScene.Models.push_back(std::move(*model));
         }
 
         return renderScene;
@@ -1,6 +1,7 @@
 #include "Subsystems/Renderer/Renderer.hpp"
 #include "Subsystems/Renderer/RenderScene.hpp"
 #include "Subsystems/SceneManager.hpp"
+#include "Subsystems/SystemScheduler/SystemScheduler.hpp"
 #include "Subsystems/EventSystem/EventManager.hpp"
 #include "Subsystems/EventSystem/EngineEvents.hpp"
 #include "Subsystems/SubsystemGetters.hpp"
@@ -64,7 +65,7 @@ namespace Rigel
         ImGui::Render();
 
         // It's more optimal to cache RenderScene and just update it instead of creating a new instance every frame
-        const auto renderScene = RenderScene::Extract(GetSceneManager()->GetLoadedScene());
+        const auto renderScene = RenderScene::Extract(GetSceneManager()->GetLoadedScenes(), *GetSystemScheduler()->GetJobSystem());
         m_Impl->Render(renderScene);
     }
 
@@ -31,17 +31,34 @@ namespace Rigel
 
     void SceneManager::UnloadCurrentScene()
     {
-        if (IsSceneLoaded())
-            m_LoadedScene->OnUnload();
+        // Cells are destroyed together with their scenes, so they go first
+        m_WorldStreamer.UnloadAllCells();
+
+        for (auto& scene : m_LoadedScenes)
+            scene->OnUnload();
+
+        m_LoadedScenes.clear();
     }
 
     SceneHandle SceneManager::CreateScene(std::string name)
     {
-        const auto scene = new Scene(GetNextSceneID(), std::move(name));
-        m_Scenes[scene->GetID()] = std::unique_ptr<Scene>(scene);
-        HandleValidator::AddHandle<HandleType::SceneHandle>(scene->GetID());
+        return AdoptScene(CreateDetachedScene(std::move(name)));
+    }
+
+    std::unique_ptr<Scene> SceneManager::CreateDetachedScene(std::string name)
+    {
+        auto scene = std::unique_ptr<Scene>(new Scene(GetNextSceneID(), std::move(name)));
+        HandleValidator::AddHandle<HandleType::SceneHandle>(*scene);
+
+        return scene;
+    }
+
+    SceneHandle SceneManager::AdoptScene(std::unique_ptr<Scene> scene)
+    {
+        const auto ptr = scene.get();
+        m_Scenes[ptr->GetID()] = std::move(scene);
 
-        return {scene, scene->GetID()};
+        return {ptr, ptr->GetID()};
     }
 
     void SceneManager::DestroyScene(const SceneHandle& scene)
@@ -53,21 +70,111 @@ namespace Rigel
         }
 
         const auto id = scene.GetID();
-        HandleValidator::RemoveHandle<HandleType::SceneHandle>(id);
+        DestroyDetachedScene(std::move(m_Scenes.at(id)));
         m_Scenes.erase(id);
     }
 
+    void SceneManager::DestroyDetachedScene(std::unique_ptr<Scene> scene)
+    {
+        // Objects unindex themselves through the scene's handle, so they must be gone before the handle is removed
+        scene->DestroyAllGameObjects();
+        HandleValidator::RemoveHandle<HandleType::SceneHandle>(*scene);
+    }
+
     void SceneManager::LoadScene(SceneHandle& scene)
     {
-        ASSERT(m_LoadedScene.GetID() != scene.GetID(), "Attempted to load the scene that's already been loaded.");
+        ASSERT(!scene->IsLoaded(), "Attempted to load the scene that's already been loaded.");
 
-        if (IsSceneLoaded())
-            m_LoadedScene->OnUnload();
+        UnloadCurrentScene();
 
         Debug::Trace("Loading scene: " + scene->GetName());
 
         scene->OnLoad();
-        m_LoadedScene = scene;
+        m_LoadedScenes.push_back(scene);
+    }
+
+    void SceneManager::LoadSceneIncremental(SceneHandle& scene, const float64_t frameBudget)
+    {
+        ASSERT(!scene->IsLoaded(), "Attempted to load the scene that's already been loaded.");
+
+        UnloadCurrentScene();
+
+        Debug::Trace("Loading scene incrementally: " + scene->GetName());
+
+        scene->OnLoad(true);
+        m_LoadedScenes.push_back(scene);
+        m_LoadFrameBudget = frameBudget;
+    }
+
+    void SceneManager::LoadSceneAdditive(SceneHandle& scene, const bool incremental)
+    {
+        if (scene->IsLoaded())
+        {
+            Debug::Error("Attempted to additively load scene with ID {}, which is already loaded!", scene.GetID());
+            return;
+        }
+
+        Debug::Trace("Loading scene additively: " + scene->GetName());
+
+        scene->OnLoad(incremental);
+        m_LoadedScenes.push_back(scene);
+    }
+
+    void SceneManager::UnloadScene(const SceneHandle& scene)
+    {
+        const auto it = std::ranges::find(m_LoadedScenes, scene.GetID(), &SceneHandle::GetID);
+        if (it == m_LoadedScenes.end())
+        {
+            Debug::Error("Attempted to unload scene with ID {}, which is not loaded!", scene.GetID());
+            return;
+        }
+
+        Debug::Trace("Unloading scene: " + scene->GetName());
+
+        (*it)->OnUnload();
+        m_LoadedScenes.erase(it);
+    }
+
+    bool SceneManager::IsLoadingScene() const
+    {
+        return std::ranges::any_of(m_LoadedScenes, [](const SceneHandle& scene) { return scene->IsLoading(); });
+    }
+
+    float32_t SceneManager::GetLoadProgress() const
+    {
+        auto progress = 1.0f;
+        for (const auto& scene : m_LoadedScenes)
+            progress = std::min(progress, scene->GetLoadProgress());
+
+        return progress;
+    }
+
+    void SceneManager::Update()
+    {
+        // Scenes loaded first are finished first, the ones after them get what is left of the budget
+        const auto stopwatch = Stopwatch::StartNew();
+        auto first = true;
+
+        for (auto& scene : m_LoadedScenes)
+        {
+            if (!scene->IsLoading())
+                continue;
+
+            // The first scene is always continued, ContinueLoad processes at least one object so loading can't stall
+            const auto budget = m_LoadFrameBudget - stopwatch.GetElapsed().AsMillisecondsD();
+            if (budget <= 0.0 && !first)
+                break;
+
+            first = false;
+
+            if (scene->ContinueLoad(budget))
+                Debug::Trace("Finished loading scene: " + scene->GetName());
+        }
+    }
+
+    void SceneManager::OnEndOfFrame()
+    {
+        m_WorldStreamer.Update();
     }
 
     SceneHandle SceneManager::GetSceneByID(const uid_t id) const
@@ -84,6 +191,6 @@ namespace Rigel
 
     SceneHandle SceneManager::GetLoadedScene() const
     {
-        return m_LoadedScene;
+        return m_LoadedScenes.empty() ? SceneHandle::Null() : m_LoadedScenes.front();
     }
 }
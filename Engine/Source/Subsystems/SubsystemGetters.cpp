@@ -47,4 +47,9 @@ namespace Rigel
     {
         return GetEngine()->GetPhysicsEngine();
     }
+
+    Ref<SystemScheduler> GetSystemScheduler()
+    {
+        return GetEngine()->GetSystemScheduler();
+    }
 }
@@ -0,0 +1,167 @@
+#include "Subsystems/SystemScheduler/SystemScheduler.hpp"
+#include "ProjectSettings.hpp"
+#include "Debug.hpp"
+
+namespace Rigel
+{
+    ErrorCode SystemScheduler::Startup(const ProjectSettings& settings)
+    {
+        Debug::Trace("Starting up system scheduler.");
+
+        m_JobSystem = std::make_unique<JobSystem>(settings.SystemSchedulerThreadPoolSize);
+
+        Debug::Trace("Created system scheduler job system with {} threads.", m_JobSystem->GetSize());
+
+        m_Initialized = true;
+        return ErrorCode::OK;
+    }
+
+    ErrorCode SystemScheduler::Shutdown()
+    {
+        Debug::Trace("Shutting down system scheduler.");
+
+        m_JobSystem.reset();
+        m_Systems.clear();
+        m_Graph.clear();
+
+        return ErrorCode::OK;
+    }
+
+    SystemScheduler::SystemID SystemScheduler::AddSystem(std::string name, ComponentAccess access, SystemFunction function)
+    {
+        const auto id = m_NextSystemID++;
+
+        m_Systems.push_back({
+            .ID = id,
+            .Name = std::move(name),
+            .Access = std::move(access),
+            .Function = std::move(function)
+        });
+
+        m_GraphDirty = true;
+        return id;
+    }
+
+    void SystemScheduler::RemoveSystem(const SystemID id)
+    {
+        if (std::erase_if(m_Systems, [id](const System& system) { return system.ID == id; }) == 0)
+        {
+            Debug::Error("Failed to remove system with ID {}, the system does not exist!", id);
+            return;
+        }
+
+        m_GraphDirty = true;
+    }
+
+    void SystemScheduler::RebuildGraph()
+    {
+        const auto count = m_Systems.size();
+
+        m_Graph.assign(count, GraphNode());
+        m_PendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(count);
+
+        // A system waits for every earlier system it conflicts with, which keeps the registration order
+        // between conflicting systems and lets everything else run in parallel
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (uint32_t j = i + 1; j < count; ++j)
+            {
+                if (m_Systems[i].Access.ConflictsWith(m_Systems[j].Access))
+                {
+                    m_Graph[i].Dependents.push_back(j);
+                    ++m_Graph[j].DependencyCount;
+                }
+            }
+        }
+
+        m_GraphDirty = false;
+    }
+
+    void SystemScheduler::Update(const GameUpdateEvent& event)
+    {
+        if (m_Systems.empty())
+            return;
+
+        if (m_GraphDirty)
+            RebuildGraph();
+
+        m_CompletedCount = 0;
+
+        for (size_t i = 0; i < m_Graph.size(); ++i)
+            m_PendingDependencies[i].store(m_Graph[i].DependencyCount, std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < m_Graph.size(); ++i)
+        {
+            if (m_Graph[i].DependencyCount == 0)
+                Schedule(i, event);
+        }
+
+        // The main thread runs exclusive systems as they become ready and returns once every system has finished
+        while (true)
+        {
+            std::unique_lock lock(m_RunMutex);
+            m_RunCondition.wait(lock, [this]
+            {
+                return m_CompletedCount == m_Systems.size() || !m_MainThreadQueue.empty();
+            });
+
+            if (m_MainThreadQueue.empty())
+                break;
+
+            const auto index = m_MainThreadQueue.back();
+            m_MainThreadQueue.pop_back();
+
+            lock.unlock();
+            RunSystem(index, event);
+        }
+    }
+
+    void SystemScheduler::Schedule(const uint32_t index, const GameUpdateEvent& event)
+    {
+        if (m_Systems[index].Access.IsExclusive() || m_JobSystem->GetSize() == 0)
+        {
+            {
+                std::unique_lock lock(m_RunMutex);
+                m_MainThreadQueue.push_back(index);
+            }
+
+            m_RunCondition.notify_one();
+            return;
+        }
+
+        // Update blocks until all systems have finished, so the event outlives every task
+        m_JobSystem->Schedule([this, index, &event]
+        {
+            RunSystem(index, event);
+        });
+    }
+
+    void SystemScheduler::RunSystem(const uint32_t index, const GameUpdateEvent& event)
+    {
+        // A system that throws still counts as finished, otherwise its dependents would never run
+        // and Update would wait forever, or return while other systems still use the event
+        try {
+            m_Systems[index].Function(event);
+        }
+        catch (const std::exception& e) {
+            Debug::Error("An exception was thrown when running system {}! Exception: {}", m_Systems[index].Name, e.what());
+        }
+        catch (...) {
+            Debug::Error("An unknown exception was thrown when running system {}!", m_Systems[index].Name);
+        }
+
+        for (const auto dependent : m_Graph[index].Dependents)
+        {
+            if (m_PendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Schedule(dependent, event);
+        }
+
+        // Counted only after the dependents were scheduled, so Update can't return while scheduling is in progress
+        {
+            std::unique_lock lock(m_RunMutex);
+            ++m_CompletedCount;
+        }
+
+        m_RunCondition.notify_one();
+    }
+}
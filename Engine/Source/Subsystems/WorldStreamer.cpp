@@ -0,0 +1,228 @@
+#include "Subsystems/WorldStreamer.hpp"
+#include "Subsystems/SceneManager.hpp"
+#include "Subsystems/SubsystemGetters.hpp"
+#include "Subsystems/AssetManager/AssetManager.hpp"
+#include "Components/Camera.hpp"
+#include "Components/Transform.hpp"
+#include "ECS/Scene.hpp"
+
+#include <format>
+#include <ranges>
+
+namespace Rigel::Backend
+{
+    void WorldStreamer::Enable(const WorldStreamingSettings& settings)
+    {
+        if (settings.CellSize <= 0.0f || settings.LoadRadius < 0 || settings.UnloadRadius < settings.LoadRadius)
+        {
+            Debug::Error("Failed to enable world streaming! Cell size must be positive and unload radius must not be smaller than load radius.");
+            return;
+        }
+
+        // Cells loaded with the old settings may not match the new grid
+        UnloadAllCells();
+
+        m_Settings = settings;
+        m_Enabled = true;
+    }
+
+    void WorldStreamer::Disable()
+    {
+        UnloadAllCells();
+        m_Enabled = false;
+    }
+
+    size_t WorldStreamer::GetLoadedCellCount() const
+    {
+        return std::ranges::count(m_Cells | std::views::values, CellState::Loaded, &Cell::State);
+    }
+
+    size_t WorldStreamer::GetPendingCellCount() const
+    {
+        return std::ranges::count(m_Cells | std::views::values, CellState::Loading, &Cell::State);
+    }
+
+    void WorldStreamer::Update()
+    {
+        if (!m_Enabled)
+            return;
+
+        for (auto it = m_Cells.begin(); it != m_Cells.end();)
+        {
+            auto& cell = it->second;
+            if (cell.State != CellState::Loading || !cell.Asset->IsLoadFinished() || IntegrateCell(cell))
+            {
+                ++it;
+                continue;
+            }
+
+            // Requested again below once the stale asset is gone
+            --m_ActiveCellCount;
+            it = m_Cells.erase(it);
+        }
+
+        const auto focus = FindFocus();
+        if (!focus)
+            return;
+
+        const auto center = glm::ivec2(glm::floor(glm::vec2(focus->x, focus->z) / m_Settings.CellSize));
+
+        for (auto it = m_Cells.begin(); it != m_Cells.end();)
+        {
+            auto& cell = it->second;
+            if (GetCellDistance(cell.Coords, center) <= m_Settings.UnloadRadius)
+            {
+                ++it;
+                continue;
+            }
+
+            if (cell.State != CellState::Empty)
+                --m_ActiveCellCount;
+
+            UnloadCell(cell);
+            it = m_Cells.erase(it);
+        }
+
+        // Nearest cells are requested first, so they get the free slots if MaxCells is reached
+        auto missing = std::vector<glm::ivec2>();
+        for (auto z = -m_Settings.LoadRadius; z <= m_Settings.LoadRadius; ++z)
+        {
+            for (auto x = -m_Settings.LoadRadius; x <= m_Settings.LoadRadius; ++x)
+            {
+                if (const auto coords = center + glm::ivec2(x, z); !m_Cells.contains(GetCellKey(coords)))
+                    missing.push_back(coords);
+            }
+        }
+
+        std::ranges::sort(missing, {}, [&center](const glm::ivec2& coords)
+        {
+            const auto delta = coords - center;
+            return delta.x * delta.x + delta.y * delta.y;
+        });
+
+        for (const auto& coords : missing)
+        {
+            const auto path = GetCellPath(coords);
+
+            // The world may be sparse, missing cells are remembered so the filesystem is only checked once
+            if (!std::filesystem::exists(path))
+            {
+                m_Cells.emplace(GetCellKey(coords), Cell{ .Coords = coords, .State = CellState::Empty });
+                continue;
+            }
+
+            if (m_ActiveCellCount >= m_Settings.MaxCells && !EvictFarthestCell(center))
+                break;
+
+            m_Cells.emplace(GetCellKey(coords), Cell{
+                .Coords = coords,
+                .State = CellState::Loading,
+                .Asset = GetAssetManager()->LoadAsync<SceneAsset>(path)
+            });
+
+            ++m_ActiveCellCount;
+        }
+    }
+
+    void WorldStreamer::UnloadAllCells()
+    {
+        for (auto& cell : m_Cells | std::views::values)
+            UnloadCell(cell);
+
+        m_Cells.clear();
+        m_ActiveCellCount = 0;
+    }
+
+    std::optional<glm::vec3> WorldStreamer::FindFocus() const
+    {
+        if (m_Focus)
+            return m_Focus;
+
+        // Same camera the renderer uses, the first one found in the order the scenes were loaded
+        for (const auto& scene : GetSceneManager()->GetLoadedScenes())
+        {
+            if (const auto cameras = scene->Query<Camera, Transform>(); !cameras.IsEmpty())
+            {
+                const auto [camera, transform] = cameras.Front();
+                return transform->GetPosition();
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::filesystem::path WorldStreamer::GetCellPath(const glm::ivec2& coords) const
+    {
+        return m_Settings.CellsDirectory / std::format("Cell_{}_{}.json", coords.x, coords.y);
+    }
+
+    bool WorldStreamer::IntegrateCell(Cell& cell)
+    {
+        // The asset is only needed to get the scene out of it
+        auto asset = std::move(cell.Asset);
+
+        if (!asset->IsOK())
+        {
+            Debug::Error("Failed to stream world cell ({}, {}) from {}.", cell.Coords.x, cell.Coords.y, asset->GetPath().string());
+
+            cell.State = CellState::Empty;
+            --m_ActiveCellCount;
+            return true;
+        }
+
+        // The asset manager hands out an asset of the same path until its unloading finishes,
+        // a cell that left and came back quickly may get the asset its previous scene was taken from
+        auto scene = asset->TakeScene();
+        if (!scene)
+            return false;
+
+        auto handle = GetSceneManager()->AdoptScene(std::move(scene));
+        GetSceneManager()->LoadSceneAdditive(handle, true);
+
+        cell.Scene = handle;
+        cell.State = CellState::Loaded;
+        return true;
+    }
+
+    void WorldStreamer::UnloadCell(Cell& cell)
+    {
+        // Releasing the asset of a cell that is still loading makes the asset manager drop it once it finishes
+        cell.Asset = AssetHandle<SceneAsset>();
+
+        if (cell.State == CellState::Loaded)
+        {
+            GetSceneManager()->UnloadScene(cell.Scene);
+            GetSceneManager()->DestroyScene(cell.Scene);
+        }
+
+        cell.Scene = SceneHandle::Null();
+        cell.State = CellState::Empty;
+    }
+
+    bool WorldStreamer::EvictFarthestCell(const glm::ivec2& center)
+    {
+        auto farthest = m_Cells.end();
+        auto farthestDistance = m_Settings.LoadRadius;
+
+        for (auto it = m_Cells.begin(); it != m_Cells.end(); ++it)
+        {
+            const auto distance = GetCellDistance(it->second.Coords, center);
+
+            if (it->second.State != CellState::Empty && distance > farthestDistance)
+            {
+                farthest = it;
+                farthestDistance = distance;
+            }
+        }
+
+        if (farthest == m_Cells.end())
+            return false;
+
+        // The cell is forgotten rather than kept as empty, so it is requested again once it is back within LoadRadius
+        UnloadCell(farthest->second);
+        m_Cells.erase(farthest);
+        --m_ActiveCellCount;
+
+        return true;
+    }
+}
@@ -0,0 +1,121 @@
+#include "Utilities/Filesystem/MappedFile.hpp"
+
+#ifdef RIGEL_PLATFORM_WINDOWS
+    // this define removes global legacy windows min/max macros that break everything when used with pch
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include "Windows.h"
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace Rigel
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0)) { }
+
+    MappedFile& MappedFile::operator = (MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+        }
+
+        return *this;
+    }
+
+    // The mapping keeps the file open on its own, so file handles are closed right after the file is mapped
+    Result<MappedFile> MappedFile::Open(const std::filesystem::path& path)
+    {
+        #ifdef RIGEL_PLATFORM_WINDOWS
+            const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+            if (file == INVALID_HANDLE_VALUE)
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_OPEN_FILE);
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                CloseHandle(file);
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_OPEN_FILE);
+            }
+
+            // Empty files can't be mapped
+            if (fileSize.QuadPart == 0)
+            {
+                CloseHandle(file);
+                return Result<MappedFile>::Ok(MappedFile());
+            }
+
+            const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+
+            if (!mapping)
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_MAP_FILE);
+
+            const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+
+            if (!view)
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_MAP_FILE);
+
+            return Result<MappedFile>::Ok(MappedFile(static_cast<const byte_t*>(view), static_cast<size_t>(fileSize.QuadPart)));
+        #else
+            const auto file = open(path.c_str(), O_RDONLY);
+            if (file == -1)
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_OPEN_FILE);
+
+            struct stat fileInfo{};
+            if (fstat(file, &fileInfo) != 0)
+            {
+                close(file);
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_OPEN_FILE);
+            }
+
+            // Empty files can't be mapped
+            const auto fileSize = static_cast<size_t>(fileInfo.st_size);
+            if (fileSize == 0)
+            {
+                close(file);
+                return Result<MappedFile>::Ok(MappedFile());
+            }
+
+            const auto view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+            close(file);
+
+            if (view == MAP_FAILED)
+                return Result<MappedFile>::Error(ErrorCode::FAILED_TO_MAP_FILE);
+
+            return Result<MappedFile>::Ok(MappedFile(static_cast<const byte_t*>(view), fileSize));
+        #endif
+    }
+
+    void MappedFile::Close()
+    {
+        if (!m_Data)
+            return;
+
+        #ifdef RIGEL_PLATFORM_WINDOWS
+            UnmapViewOfFile(m_Data);
+        #else
+            munmap(const_cast<byte_t*>(m_Data), m_Size);
+        #endif
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+}
@@ -0,0 +1,529 @@
+#include "Utilities/Threading/JobSystem.hpp"
+#include "Debug.hpp"
+
+namespace Rigel
+{
+    namespace Backend
+    {
+        // Edge of the job graph, the dependent is queued once the job the link belongs to has finished
+        struct JobLink
+        {
+            Job* Dependent;
+            JobLink* Next;
+        };
+    }
+
+    using Backend::Job;
+    using Backend::JobLink;
+
+    static constexpr size_t MAX_CACHED_JOBS = 1024;
+    static constexpr size_t IDLE_SPIN_COUNT = 64;
+    static constexpr int64_t INITIAL_DEQUE_CAPACITY = 256;
+
+    // Placed into Job::Dependents when a job finishes, no dependents can be added after that
+    static JobLink s_FinishedSentinel{};
+
+    // Finished jobs are kept by the thread that released them, so that allocating a job needs no synchronization
+    class JobCache
+    {
+    public:
+        ~JobCache()
+        {
+            while (m_Head)
+                delete std::exchange(m_Head, m_Head->Next);
+        }
+
+        NODISCARD Job* Pop()
+        {
+            if (!m_Head)
+                return nullptr;
+
+            --m_Size;
+            return std::exchange(m_Head, m_Head->Next);
+        }
+
+        NODISCARD bool Push(Job* job)
+        {
+            if (m_Size == MAX_CACHED_JOBS)
+                return false;
+
+            job->Next = std::exchange(m_Head, job);
+            ++m_Size;
+            return true;
+        }
+    private:
+        Job* m_Head = nullptr;
+        size_t m_Size = 0;
+    };
+
+    struct JobThreadState
+    {
+        const JobSystem* System = nullptr;
+        int32_t WorkerIndex = -1;
+    };
+
+    static thread_local JobCache s_JobCache;
+    static thread_local JobThreadState s_ThreadState;
+
+    bool Job::IsFinished() const
+    {
+        return Dependents.load(std::memory_order_acquire) == &s_FinishedSentinel;
+    }
+
+    Job* Job::Allocate()
+    {
+        const auto job = s_JobCache.Pop();
+        if (!job)
+            return new Job();
+
+        job->Dependents.store(nullptr, std::memory_order_relaxed);
+        job->Next = nullptr;
+        return job;
+    }
+
+    void Job::RemoveReference(Job* job)
+    {
+        if (job->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        if (!s_JobCache.Push(job))
+            delete job;
+    }
+
+    static bool AddDependent(Job* job, Job* dependent)
+    {
+        const auto link = new JobLink{dependent, nullptr};
+        Job::AddReference(dependent);
+
+        auto head = job->Dependents.load(std::memory_order_acquire);
+
+        do
+        {
+            if (head == &s_FinishedSentinel)
+            {
+                delete link;
+                Job::RemoveReference(dependent);
+                return false;
+            }
+
+            link->Next = head;
+        }
+        while (!job->Dependents.compare_exchange_weak(head, link, std::memory_order_release, std::memory_order_acquire));
+
+        return true;
+    }
+
+    /**
+     * A worker's share of the queued jobs. The deque is a Chase-Lev deque, the owner pushes and pops
+     * at the bottom while other threads steal from the top. Jobs scheduled from threads outside of the
+     * job system are posted to the inbox, a lock-free stack the owner moves into its deque.
+     */
+    class JobSystem::Worker
+    {
+    public:
+        Worker()
+        {
+            m_Buffers.push_back(std::make_unique<Buffer>(INITIAL_DEQUE_CAPACITY));
+            m_Buffer.store(m_Buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        // Owner only
+        void Push(Job* job)
+        {
+            const auto bottom = m_Bottom.load(std::memory_order_relaxed);
+            const auto top = m_Top.load(std::memory_order_acquire);
+            auto buffer = m_Buffer.load(std::memory_order_relaxed);
+
+            if (bottom - top > buffer->Capacity - 1)
+                buffer = Grow(buffer, bottom, top);
+
+            buffer->Put(bottom, job);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // Owner only
+        NODISCARD Job* Pop()
+        {
+            const auto bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+            const auto buffer = m_Buffer.load(std::memory_order_relaxed);
+
+            m_Bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            auto top = m_Top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            auto job = buffer->Get(bottom);
+
+            // The last job, thieves may be racing for it
+            if (top == bottom)
+            {
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    job = nullptr;
+
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return job;
+        }
+
+        NODISCARD Job* Steal()
+        {
+            auto top = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto bottom = m_Bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            const auto job = m_Buffer.load(std::memory_order_acquire)->Get(top);
+
+            if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return job;
+        }
+
+        // Pushes a chain of jobs linked through Job::Next
+        void PostToInbox(Job* first, Job* last)
+        {
+            auto head = m_Inbox.load(std::memory_order_relaxed);
+
+            do
+            {
+                last->Next = head;
+            }
+            while (!m_Inbox.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Returns all posted jobs, the most recent one first
+        NODISCARD Job* TakeInbox()
+        {
+            if (!m_Inbox.load(std::memory_order_relaxed))
+                return nullptr;
+
+            return m_Inbox.exchange(nullptr, std::memory_order_acquire);
+        }
+    private:
+        struct Buffer
+        {
+            explicit Buffer(const int64_t capacity) : Capacity(capacity), Items(new std::atomic<Job*>[capacity]) { }
+
+            NODISCARD Job* Get(const int64_t index) const { return Items[index & (Capacity - 1)].load(std::memory_order_relaxed); }
+            void Put(const int64_t index, Job* job) { Items[index & (Capacity - 1)].store(job, std::memory_order_relaxed); }
+
+            int64_t Capacity;
+            std::unique_ptr<std::atomic<Job*>[]> Items;
+        };
+
+        Buffer* Grow(const Buffer* buffer, const int64_t bottom, const int64_t top)
+        {
+            auto grown = std::make_unique<Buffer>(buffer->Capacity * 2);
+            for (auto i = top; i < bottom; ++i)
+                grown->Put(i, buffer->Get(i));
+
+            // Thieves may still read the old buffer, buffers are only freed together with the worker
+            m_Buffers.push_back(std::move(grown));
+            m_Buffer.store(m_Buffers.back().get(), std::memory_order_release);
+
+            return m_Buffers.back().get();
+        }
+
+        alignas(64) std::atomic<int64_t> m_Top = 0;
+        alignas(64) std::atomic<int64_t> m_Bottom = 0;
+        std::atomic<Buffer*> m_Buffer = nullptr;
+        std::vector<std::unique_ptr<Buffer>> m_Buffers;
+
+        alignas(64) std::atomic<Job*> m_Inbox = nullptr;
+    };
+
+    JobSystem::JobSystem(const size_t numThreads)
+    {
+        m_WorkerCount = numThreads == 0 ? std::thread::hardware_concurrency() : numThreads;
+        m_Workers = std::make_unique<Worker[]>(m_WorkerCount);
+
+        for (size_t i = 0; i < m_WorkerCount; ++i)
+        {
+            m_Threads.emplace_back([this, i] { WorkerLoop(static_cast<int32_t>(i)); });
+            m_ThreadIDs.push_back(m_Threads.back().get_id());
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        WaitForAll();
+
+        {
+            std::unique_lock lock(m_SleepMutex);
+            m_ShouldStop = true;
+        }
+        m_SleepCondition.notify_all();
+
+        for (auto& thread : m_Threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    int32_t JobSystem::GetCurrentWorkerIndex() const
+    {
+        return s_ThreadState.System == this ? s_ThreadState.WorkerIndex : -1;
+    }
+
+    void JobSystem::Wait(const JobHandle& handle)
+    {
+        const auto workerIndex = GetCurrentWorkerIndex();
+
+        while (!handle.IsFinished())
+        {
+            if (const auto job = FindJob(workerIndex))
+                Execute(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::Wait(std::span<const JobHandle> handles)
+    {
+        for (const auto& handle : handles)
+            Wait(handle);
+    }
+
+    void JobSystem::WaitForAll()
+    {
+        const auto workerIndex = GetCurrentWorkerIndex();
+
+        while (m_UnfinishedJobs.load(std::memory_order_acquire) > 0)
+        {
+            if (const auto job = FindJob(workerIndex))
+            {
+                Execute(job);
+                continue;
+            }
+
+            // The rest is running on the workers
+            std::unique_lock lock(m_SleepMutex);
+            m_CompletionCondition.wait(lock, [this]
+            {
+                return m_UnfinishedJobs.load(std::memory_order_acquire) == 0;
+            });
+        }
+    }
+
+    bool JobSystem::TryExecuteJob()
+    {
+        const auto job = FindJob(GetCurrentWorkerIndex());
+        if (!job)
+            return false;
+
+        Execute(job);
+        return true;
+    }
+
+    JobHandle JobSystem::Submit(Job* job, std::span<const JobHandle> dependencies)
+    {
+        // One reference is released once the job finishes, the other one belongs to the returned handle
+        job->RefCount.store(2, std::memory_order_relaxed);
+
+        // Keeps the job from being queued by a dependency that finishes while the rest are being linked
+        job->PendingDependencies.store(1, std::memory_order_relaxed);
+
+        m_UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+        for (const auto& dependency : dependencies)
+        {
+            if (!dependency.m_Job)
+                continue;
+
+            job->PendingDependencies.fetch_add(1, std::memory_order_relaxed);
+
+            if (!AddDependent(dependency.m_Job, job))
+                job->PendingDependencies.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        if (job->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Enqueue(job);
+
+        return JobHandle(job);
+    }
+
+    void JobSystem::Enqueue(Job* job)
+    {
+        m_QueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_WorkerCount == 0)
+        {
+            Execute(job);
+            return;
+        }
+
+        if (const auto workerIndex = GetCurrentWorkerIndex(); workerIndex >= 0)
+            m_Workers[workerIndex].Push(job);
+        else
+            m_Workers[m_NextInbox.fetch_add(1, std::memory_order_relaxed) % m_WorkerCount].PostToInbox(job, job);
+
+        WakeWorkers(1);
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        try {
+            job->Invoke(*job);
+        }
+        catch (const std::exception& e) {
+            Debug::Error("An exception was thrown when executing a job! Exception: {}", e.what());
+        }
+        catch (...) {
+            Debug::Error("An unknown exception was thrown when executing a job!");
+        }
+
+        // Always reached, threads waiting for the job or its dependents would hang otherwise
+        job->Destroy(*job);
+        Finish(job);
+    }
+
+    void JobSystem::Finish(Job* job)
+    {
+        auto link = job->Dependents.exchange(&s_FinishedSentinel, std::memory_order_acq_rel);
+
+        while (link)
+        {
+            const auto dependent = link->Dependent;
+
+            if (dependent->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Enqueue(dependent);
+
+            Job::RemoveReference(dependent);
+            delete std::exchange(link, link->Next);
+        }
+
+        Job::RemoveReference(job);
+
+        // Dependents are counted as unfinished from the moment they are scheduled, so WaitForAll can't return early
+        if (m_UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            {
+                std::unique_lock lock(m_SleepMutex);
+            }
+            m_CompletionCondition.notify_all();
+        }
+    }
+
+    Job* JobSystem::FindJob(const int32_t workerIndex)
+    {
+        if (workerIndex >= 0)
+        {
+            auto& worker = m_Workers[workerIndex];
+
+            if (const auto job = worker.Pop())
+                return job;
+
+            if (const auto jobs = worker.TakeInbox())
+                return MoveToDeque(worker, jobs);
+        }
+
+        // Victims are visited starting next to the thief, so that thieves don't all go after the same worker
+        const auto start = static_cast<size_t>(workerIndex + 1);
+
+        for (size_t i = 0; i < m_WorkerCount; ++i)
+        {
+            const auto victim = (start + i) % m_WorkerCount;
+            if (static_cast<int32_t>(victim) == workerIndex)
+                continue;
+
+            if (const auto job = m_Workers[victim].Steal())
+                return job;
+        }
+
+        // Inboxes of busy workers are taken over as a whole. Threads outside of the job system have no deque
+        // to move the jobs to, they only steal jobs that have already reached a deque
+        if (workerIndex < 0)
+            return nullptr;
+
+        for (size_t i = 0; i < m_WorkerCount; ++i)
+        {
+            const auto victim = (start + i) % m_WorkerCount;
+            if (static_cast<int32_t>(victim) == workerIndex)
+                continue;
+
+            if (const auto jobs = m_Workers[victim].TakeInbox())
+                return MoveToDeque(m_Workers[workerIndex], jobs);
+        }
+
+        return nullptr;
+    }
+
+    Job* JobSystem::MoveToDeque(Worker& worker, Job* jobs)
+    {
+        // Inboxes hold the most recent job first, pushing them in that order makes the owner pop them in the order
+        // they were posted. The oldest one is returned right away.
+        while (jobs->Next)
+        {
+            const auto next = jobs->Next; // Read before pushing, a pushed job may be stolen and recycled at once
+            worker.Push(jobs);
+            jobs = next;
+        }
+
+        return jobs;
+    }
+
+    void JobSystem::WorkerLoop(const int32_t workerIndex)
+    {
+        s_ThreadState = {this, workerIndex};
+
+        while (true)
+        {
+            auto job = FindJob(workerIndex);
+
+            // Jobs tend to come in bursts, spinning for a moment avoids going to sleep right before the next one
+            for (size_t spin = 0; !job && spin < IDLE_SPIN_COUNT; ++spin)
+            {
+                std::this_thread::yield();
+                job = FindJob(workerIndex);
+            }
+
+            if (job)
+            {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock lock(m_SleepMutex);
+
+            m_Sleepers.fetch_add(1, std::memory_order_seq_cst);
+            m_SleepCondition.wait(lock, [this]
+            {
+                return m_ShouldStop || m_QueuedJobs.load(std::memory_order_seq_cst) > 0;
+            });
+            m_Sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+            if (m_ShouldStop)
+                return;
+        }
+    }
+
+    void JobSystem::WakeWorkers(const size_t count)
+    {
+        if (m_Sleepers.load(std::memory_order_seq_cst) == 0)
+            return;
+
+        // Taking the lock guarantees that a worker about to sleep either sees the new job or gets the notification
+        {
+            std::unique_lock lock(m_SleepMutex);
+        }
+
+        if (count == 1)
+            m_SleepCondition.notify_one();
+        else
+            m_SleepCondition.notify_all();
+    }
+}
@@ -0,0 +1,94 @@
+#include "Utilities/Threading/Parallel.hpp"
+#include "Utilities/ScopeGuard.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace Rigel::Backend
+{
+    void ParallelLoop(JobSystem& jobs, const size_t count, const size_t grainSize, const size_t maxHelpers, const ParallelBody& body)
+    {
+        struct SharedState
+        {
+            const ParallelBody* Body;
+            size_t Count;
+            size_t Grain;
+            size_t Participants;
+            std::atomic<size_t> Next = 0;
+            std::atomic<size_t> PendingHelpers = 0;
+            ParallelException Exception;
+        };
+
+        static constexpr auto runChunks = [](SharedState& state) noexcept
+        {
+            try
+            {
+                while (true)
+                {
+                    // Guided scheduling, chunks shrink with the remaining work so that all threads finish at about the same time
+                    const auto claimed = state.Next.load(std::memory_order_relaxed);
+                    if (claimed >= state.Count)
+                        return;
+
+                    const auto chunk = std::max(state.Grain, (state.Count - claimed) / (2 * state.Participants));
+                    const auto begin = state.Next.fetch_add(chunk, std::memory_order_relaxed);
+                    if (begin >= state.Count)
+                        return;
+
+                    (*state.Body)(begin, std::min(begin + chunk, state.Count));
+                }
+            }
+            catch (...)
+            {
+                // Stops the other threads from claiming more work
+                state.Exception.Capture();
+                state.Next.store(state.Count, std::memory_order_relaxed);
+            }
+        };
+
+        if (count == 0)
+            return;
+
+        const auto grain = std::max<size_t>(grainSize, 1);
+        const auto helperCount = std::min({maxHelpers, jobs.GetSize(), std::max<size_t>(count / grain, 1) - 1});
+
+        // Not worth scheduling anything
+        if (helperCount == 0)
+        {
+            body(0, count);
+            return;
+        }
+
+        auto state = SharedState{
+            .Body = &body,
+            .Count = count,
+            .Grain = grain,
+            .Participants = helperCount + 1
+        };
+
+        state.PendingHelpers.store(helperCount, std::memory_order_relaxed);
+
+        // Helpers only capture a pointer to the shared state and are tracked by the counter, their handles are dropped
+        for (size_t i = 0; i < helperCount; ++i)
+        {
+            jobs.Schedule([statePtr = &state]
+            {
+                // The calling thread spins on the counter and the state lives on its stack, the helper must always check out
+                auto guard = ScopeGuard([statePtr] { statePtr->PendingHelpers.fetch_sub(1, std::memory_order_release); });
+                runChunks(*statePtr);
+            });
+        }
+
+        runChunks(state);
+
+        // By now only the last chunks of other threads or helpers that started too late to find any work remain,
+        // queued helpers may be picked up by the calling thread itself
+        while (state.PendingHelpers.load(std::memory_order_acquire) != 0)
+        {
+            if (!jobs.TryExecuteJob())
+                std::this_thread::yield();
+        }
+
+        state.Exception.Rethrow();
+    }
+}
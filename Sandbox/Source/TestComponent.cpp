@@ -12,7 +12,6 @@ bool TestComponent::Deserialize(const nlohmann::json& json)
 
 void TestComponent::OnStart()
 {
-    SubscribeEvent<Rigel::GameUpdateEvent>(&TestComponent::OnGameUpdate);
     m_ModelRenderer = this->GetGameObject()->GetComponent<Rigel::ModelRenderer>();
 }
 
@@ -6,6 +6,7 @@ class TestComponent final : public Rigel::Component
 {
 public:
     RIGEL_REGISTER_COMPONENT(TestComponent);
+    RIGEL_BATCHED_UPDATE(TestComponent, OnGameUpdate);
 
     NODISCARD nlohmann::json Serialize() const override;
     bool Deserialize(const nlohmann::json& json) override;